@@ -1,4 +1,4 @@
-///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
+﻿///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
 ///
 /// @file   log_stream.hpp
 /// @brief  日志文件
@@ -10,11 +10,18 @@
 #ifndef MY_LOG_INCLUDE_LOG_STREAM_H_
 #define MY_LOG_INCLUDE_LOG_STREAM_H_
 
+#include <memory_resource>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <thread>
+#include <type_traits>
 
 #include "log_wrapper.hpp"
+#include "my_log/format_number.hpp"
+#include "my_log/format_range.hpp"
+#include "my_log/memory_pool.hpp"
+#include "my_log/small_buffer.hpp"
 
 #undef TRACE
 #undef DEBUG
@@ -31,103 +38,90 @@ enum log_level_enum {
   WARN = static_cast<unsigned>(lee::level_enum::warn),
   ERROR = static_cast<unsigned>(lee::level_enum::error),
   CRITICAL = static_cast<unsigned>(lee::level_enum::critical),
-  OFF = static_cast<unsigned>(lee::level_enum::trace),
+  OFF = static_cast<unsigned>(lee::level_enum::off),
 };
 
 namespace lee {
 inline namespace log {
+/// @name     log_stream
+/// @brief    LOG(X) 返回的临时对象, 析构时把拼好的日志交给 log_wrapper
+/// @details  内容写在 DEFAULT_INLINE_BUFFER_SIZE 字节的内联缓冲区里, 超出才
+///           在堆上分配. 算术类型和指针用 format_number 格式化(浮点数输出
+///           最短往返表示), 字符串直接追加, 容器等由 format_value 输出,
+///           只有用户自定义类型才经过 std::ostream. 超出内联缓冲区后使用
+///           构造时给定的 resource, 默认是 current_log_resource().
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 17:40:26
+/// @warning  线程不安全; 只能移动不能复制
 class log_stream {
  public:
-  log_stream(const log_level_enum& level, const std::thread::id thread_id,
-             const std::string& file_name, const std::string& func_name,
-             const int line)
-      : level_(level),
-        thread_id_(thread_id),
-        file_name_(file_name),
-        func_name_(func_name),
-        line_(line) {}
+  explicit log_stream(const log_site& site) : site_(&site) {}
+  log_stream(const log_site& site, std::pmr::memory_resource* resource)
+      : buffer_(resource), site_(&site) {}
 
   ~log_stream() {
-    if (log_.empty()) {
+    if (buffer_.empty() || site_->level == ::lee::level_enum::off) {
       return;
     }
-
-    if (TRACE == level_) {
-      ::lee::log::log_wrapper::get_instance().write_log(
-          thread_id_, file_name_, func_name_, line_, ::lee::level_enum::trace,
-          log_);
-    } else if (DEBUG == level_) {
-      ::lee::log::log_wrapper::get_instance().write_log(
-          thread_id_, file_name_, func_name_, line_, ::lee::level_enum::debug,
-          log_);
-    } else if (INFO == level_) {
-      ::lee::log::log_wrapper::get_instance().write_log(
-          thread_id_, file_name_, func_name_, line_, ::lee::level_enum::info,
-          log_);
-    } else if (WARN == level_) {
-      ::lee::log::log_wrapper::get_instance().write_log(
-          thread_id_, file_name_, func_name_, line_, ::lee::level_enum::warn,
-          log_);
-    } else if (ERROR == level_) {
-      ::lee::log::log_wrapper::get_instance().write_log(
-          thread_id_, file_name_, func_name_, line_, ::lee::level_enum::error,
-          log_);
-    } else if (CRITICAL == level_) {
-      ::lee::log::log_wrapper::get_instance().write_log(
-          thread_id_, file_name_, func_name_, line_,
-          ::lee::level_enum::critical, log_);
-    } else if (OFF == level_) {
-      /// DONOTHING
-    } else {
-      /// DONOTHING
-    }
+    ::lee::log::log_wrapper::get_instance().write_log(*site_, buffer_.view());
   }
 
-  log_stream(const log_stream& other)
-      : log_(other.log_),
-        level_(other.level_),
-        thread_id_(other.thread_id_),
-        file_name_(other.file_name_),
-        func_name_(other.func_name_),
-        line_(other.line_) {}
+  log_stream(log_stream&& other) noexcept
+      : buffer_(std::move(other.buffer_)), site_(other.site_) {}
 
+  log_stream(const log_stream& other) = delete;
   log_stream& operator=(const log_stream& other) = delete;
+  log_stream& operator=(log_stream&& other) = delete;
+
+  /// 目前已经拼好的内容
+  std::string str() const { return buffer_.str(); }
 
   template <typename T>
   log_stream& operator<<(const T& data) {
-    std::stringstream stream;
-    stream << data;
-    log_ += stream.str();
-    return *this;
-  }
-
-  log_stream& operator<<(const bool& data) {
-    log_ += data ? "true" : "false";
+    if constexpr (std::is_same_v<T, const char*> || std::is_same_v<T, char*>) {
+      buffer_.append(data != nullptr ? std::string_view(data)
+                                     : std::string_view("(null)"));
+    } else if constexpr (is_number_formattable<T>::value) {
+      char* out = buffer_.prepare(MAX_NUMBER_SIZE);
+      buffer_.commit(static_cast<std::size_t>(format_number(out, data) - out));
+    } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+      buffer_.append(std::string_view(data));
+    } else if constexpr (is_range_formattable<T>::value) {
+      format_value(buffer_, data);
+    } else {
+      std::ostringstream stream;
+      stream << data;
+      buffer_.append(stream.str());
+    }
     return *this;
   }
 
  private:
-  std::string log_;
-  const log_level_enum level_;
-  const std::thread::id thread_id_;
-  const std::string file_name_;
-  const std::string func_name_;
-  const int line_;
+  small_buffer<> buffer_;
+  const log_site* const site_;  ///< 调用点的静态信息, 由 LOG(X) 定义
 };
 
-inline ::lee::log::log_stream log_stream_helper(const log_level_enum& level,
-                                                const std::thread::id thread_id,
-                                                const std::string& file_name,
-                                                const std::string& func_name,
-                                                const int line) {
-  return ::lee::log::log_stream(level, thread_id, file_name, func_name, line);
+inline ::lee::log::log_stream log_stream_helper(const log_site& site) {
+  return ::lee::log::log_stream(site);
 }
 
 }  // namespace log
 }  // namespace lee
 
-#define LOG(X)                                                           \
-  ::lee::log::log_stream_helper(X, std::this_thread::get_id(), __FILE__, \
-                                __func__, __LINE__)
+/// 低于 LEE_LOG_ACTIVE_LEVEL 的等级由 if constexpr 丢弃; 模块等级或输出不接收时
+/// 只做一次比较. 两种情况下后面的 << 都不会被求值, 也不会构造 log_stream.
+/// switch 的初始化语句里定义本调用点的 log_site, 且不会与外层的 else 错配
+#define LOG(X)                                                          \
+  if constexpr (!::lee::log::level_compiled_in(                         \
+                    static_cast<::lee::level_enum>(X))) {               \
+  } else if (!::lee::log::log_wrapper::should_log(                      \
+                 LEE_MODULE_SITE(), static_cast<::lee::level_enum>(X))) { \
+  } else                                                                \
+    switch (                                                            \
+        LEE_LOG_SITE(_lee_log_site__, static_cast<::lee::level_enum>(X)); \
+        0)                                                              \
+    default:                                                            \
+      ::lee::log::log_stream_helper(_lee_log_site__)
 
 #endif  // end of MY_LOG_INCLUDE_LOG_STREAM_H_
@@ -14,15 +14,34 @@
 #ifndef INCLUDE_LOG_WRAPPER_HPP_
 #define INCLUDE_LOG_WRAPPER_HPP_
 
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <memory_resource>
 #include <mutex>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <vector>
 
+#include "my_log/async.hpp"
+#include "my_log/dist_sink.hpp"
+#include "my_log/epoch.hpp"
+#include "my_log/format_number.hpp"
+#include "my_log/format_range.hpp"
+#include "my_log/format_string.hpp"
 #include "my_log/lazy_string.hpp"
 #include "my_log/log.hpp"
+#include "my_log/memory_pool.hpp"
+#include "my_log/module_level.hpp"
+#include "my_log/registry.hpp"
 #include "my_log/os.hpp"
+#include "my_log/small_buffer.hpp"
+#include "my_log/static_logger.hpp"
+#include "my_log/thread_ring.hpp"
+#include "my_log/tsc_clock.hpp"
 
 
 namespace lee {
@@ -40,6 +59,90 @@ class log_wrapper {
     return *instance;
   }
 
+  /**
+   * @name     write_log
+   * @brief    把日志格式化后交给文件和控制台输出
+
+   * @param    site         [in]    调用点的静态信息(文件名、函数名、行号、等级)
+   * @param    log          [in]    日志信息
+
+   * @return   NONE
+   * @author   Lijiancong, pipinstall@163.com
+   * @date     2026-10-17 14:12:20
+   * @warning  线程安全
+   */
+  void write_log(const log_site& site, std::string_view log) {
+    if (async_worker_.load(std::memory_order_relaxed) != nullptr) {
+      /// 读取和使用后台对象都在 epoch 临界区内, disable_async 等这些调用
+      /// 结束后才释放它; 后台已停止时改为同步写入
+      epoch_domain::guard guard(epoch_domain::global());
+      auto* worker = async_worker_.load(std::memory_order_seq_cst);
+      if (worker != nullptr) {
+        async_msg msg;
+        msg.level = site.level;
+        msg.site = &site;
+        msg.time = log_clock::now();
+        msg.thread = lee::current_thread_identity_ptr();
+        msg.msg.assign(log.data(), log.size());
+        if (worker->post_log(std::move(msg))) {
+          return;
+        }
+      }
+    }
+    log_record record;
+    record.site = &site;
+    record.time = log_clock::now();
+    record.thread = &lee::current_thread_identity();
+    record.payload = log;
+    base_log(record);
+  }
+
+  /**
+   * @name     write_log
+   * @brief    LOG_* 宏的拼接结果按准确长度一次写入栈上的缓冲区, 短日志不分配内存
+
+   * @param    site         [in]    调用点的静态信息
+   * @param    log          [in]    惰性拼接的日志信息
+
+   * @return   NONE
+   * @author   Lijiancong, pipinstall@163.com
+   * @date     2026-10-17 20:40:12
+   * @warning  线程安全
+   */
+  template <typename... Pieces>
+  void write_log(const log_site& site,
+                 const lazy_string_concat_helper<Pieces...>& log) {
+    write_lazy_log_(site, log);
+  }
+
+  /// LOG_* 宏有多个参数时的拼接结果, 同上
+  template <typename... Pieces>
+  void write_log(const log_site& site,
+                 const lazy_string_pieces<Pieces...>& log) {
+    write_lazy_log_(site, log);
+  }
+
+  /**
+   * @name     write_log_fmt
+   * @brief    按 "{}" 格式串一遍拼好日志再写入, 短日志只用栈上的缓冲区
+
+   * @param    site         [in]    调用点的静态信息
+   * @param    fmt          [in]    格式串, 由 LEE_CHECK_FORMAT 在编译期检查
+   * @param    args         [in]    参数
+
+   * @return   NONE
+   * @author   Lijiancong, pipinstall@163.com
+   * @date     2026-10-17 20:10:37
+   * @warning  线程安全
+   */
+  template <typename... Args>
+  void write_log_fmt(const log_site& site, std::string_view fmt,
+                     const Args&... args) {
+    small_buffer<> buffer;
+    format_to(buffer, fmt, args...);
+    write_log(site, buffer.view());
+  }
+
   /**
  * @name     write_log
  * @brief    主要进行C语言字符串整合为string型，
@@ -54,145 +157,347 @@ class log_wrapper {
  * @return   NONE
  * @author   Lijiancong, pipinstall@163.com
  * @date     2019-09-17 11:03:46
- * @warning  线程安全
+ * @warning  线程安全; 日志宏已改用 log_site 版本, 这里保留给直接调用的代码;
+ *           thread_id 不再使用, 日志中总是记录当前线程的标识;
+ *           调用点信息是临时的, 所以异步模式下也直接同步写入
  */
   void write_log(const std::thread::id thread_id, const std::string& file_name,
                  const std::string& func_name, const int line,
                  const lee::level_enum& level, const std::string& log) {
-    auto formated_log =
-        get_format_log(thread_id, file_name, func_name, line, level, log);
-    base_log(level, formated_log);
+    const log_site site{level, file_basename(file_name.c_str()),
+                        func_name.c_str(), line, 0};
+    (void)thread_id;
+    log_record record;
+    record.site = &site;
+    record.time = log_clock::now();
+    record.thread = &lee::current_thread_identity();
+    record.payload = log;
+    base_log(record);
+  }
+
+  /**
+   * @name     enable_async
+   * @brief    开启异步模式, write_log 只负责把记录放进有界队列,
+   *           由一个后台线程写入文件和控制台
+
+   * @param    queue_size   [in]    队列长度(条), thread_ring 模式下为每个线程的队列长度
+   * @param    policy       [in]    队列满时的处理策略
+   * @param    mode         [in]    共用一个队列还是每个线程一个队列
+
+   * @return   NONE
+   * @author   Lijiancong, pipinstall@163.com
+   * @date     2026-10-17 09:31:05
+   * @warning  应在其他线程开始打日志之前调用; 已开启时调用无效
+   */
+  void enable_async(std::size_t queue_size = DEFAULT_ASYNC_QUEUE_SIZE,
+                    overflow_policy policy = overflow_policy::block,
+                    async_mode mode = async_mode::shared_queue) {
+    std::lock_guard<std::mutex> lock(async_mutex_);
+    if (async_owner_) {
+      return;
+    }
+    auto handler = [this](const async_msg& msg) {
+      if (msg.type == async_msg_type::flush) {
+        logger.flush();
+      } else {
+        base_log(msg.record());
+      }
+    };
+    if (mode == async_mode::thread_ring) {
+      async_owner_.reset(new thread_ring_worker(queue_size, policy, handler));
+    } else {
+      async_owner_.reset(new async_worker(queue_size, policy, handler));
+    }
+    async_worker_.store(async_owner_.get(), std::memory_order_release);
+
+    /// 进程正常退出时保证队列中的日志被写完
+    static std::once_flag exit_flag;
+    std::call_once(exit_flag, [] {
+      std::atexit([] { log_wrapper::get_instance().disable_async(); });
+    });
   }
 
-  void set_file_log_level(level_enum log_level) { logger.set_level(log_level); }
+  /**
+   * @name     disable_async
+   * @brief    关闭异步模式, 写完队列中剩余的日志后回到同步模式.
+   *           先等已经读到后台对象的 write_log 投递结束, 再停止并释放它,
+   *           其他线程可以一直打日志
+
+   * @return   NONE
+   * @author   Lijiancong, pipinstall@163.com
+   * @date     2026-10-17 09:33:47
+   * @warning  线程安全; 不能在 sink 的 log 中调用
+   */
+  void disable_async() {
+    std::lock_guard<std::mutex> lock(async_mutex_);
+    if (!async_owner_) {
+      return;
+    }
+    async_worker_.store(nullptr, std::memory_order_seq_cst);
+    /// 后台线程仍在运行, 因队列满而等待的生产者也能结束
+    auto& domain = epoch_domain::global();
+    const auto retired = domain.retire();
+    while (!domain.can_reclaim(retired)) {
+      std::this_thread::yield();
+    }
+    async_owner_->stop();
+    async_owner_.reset();
+    logger.flush();
+  }
+
+  bool is_async() const {
+    return async_worker_.load(std::memory_order_acquire) != nullptr;
+  }
+
+  /// 异步模式下各个溢出策略被阻塞/丢弃的条数, 同步模式下全部为0
+  overflow_counters async_overflow_counters() {
+    std::lock_guard<std::mutex> lock(async_mutex_);
+    return async_owner_ ? async_owner_->counters() : overflow_counters();
+  }
+
+  void set_file_log_level(level_enum log_level) {
+    std::lock_guard<std::mutex> lock(level_mutex_);
+    logger.set_level(log_level);
+    update_min_level_();
+  }
 
   void set_console_log_level(level_enum log_level) {
+    std::lock_guard<std::mutex> lock(level_mutex_);
     cout_logger.set_level(log_level);
+    update_min_level_();
+  }
+
+  /**
+   * @name     add_sink
+   * @brief    运行时加一个输出, 如给正在运行的进程临时挂一个调试文件;
+   *           写日志的线程不会因此被阻塞
+
+   * @param    child    [in]    新的输出, 按它自己的等级过滤
+
+   * @return   NONE
+   * @author   Lijiancong, pipinstall@163.com
+   * @date     2026-10-17 22:55:18
+   * @warning  线程安全; 之后再修改 child 的等级需调用 refresh_sink_levels
+   */
+  void add_sink(std::shared_ptr<sink> child) {
+    std::lock_guard<std::mutex> lock(level_mutex_);
+    extra_sinks.add_sink(std::move(child));
+    update_min_level_();
+  }
+
+  /// 移除 add_sink 加入的输出, 正在写入它的调用结束后才释放
+  bool remove_sink(const std::shared_ptr<sink>& child) {
+    std::lock_guard<std::mutex> lock(level_mutex_);
+    const bool removed = extra_sinks.remove_sink(child);
+    update_min_level_();
+    return removed;
+  }
+
+  /// 重新读取 add_sink 加入的输出的等级
+  void refresh_sink_levels() {
+    std::lock_guard<std::mutex> lock(level_mutex_);
+    update_min_level_();
+  }
+
+  /**
+   * @name     should_log
+   * @brief    是否至少有一个输出会接收该等级的日志,
+   *           日志宏在求值参数之前先用它判断
+
+   * @param    level    [in]    日志等级
+
+   * @return   有输出接收则返回真
+   * @author   Lijiancong, pipinstall@163.com
+   * @date     2026-10-17 15:10:42
+   * @warning  线程安全; 不需要先构造单例, 只读一个原子变量
+   */
+  static bool should_log(level_enum level) {
+    return static_cast<int>(level) >= min_level_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @name     should_log
+   * @brief    同上, 另外按调用点所属模块的等级过滤, 参见 module_levels.
+   *           结果缓存在调用点, 规则或输出的等级改变之前只比较一次
+
+   * @param    site     [in]    本调用点的 module_site, 由 LEE_MODULE_SITE 定义
+   * @param    level    [in]    日志等级
+
+   * @return   模块等级和输出都接收该等级时返回真
+   * @author   Lijiancong, pipinstall@163.com
+   * @date     2026-10-17 23:55:31
+   * @warning  线程安全
+   */
+  static bool should_log(module_site& site, level_enum level) {
+    return site.should_log(
+        level, [](std::string_view module, std::string_view file) {
+          return std::max(
+              module_levels::get_instance().effective_level(module, file),
+              min_level());
+        });
+  }
+
+  /// 文件、控制台和 add_sink 加入的输出中最低的等级
+  static level_enum min_level() {
+    return static_cast<level_enum>(min_level_.load(std::memory_order_relaxed));
   }
 
   void set_flush_file_level(level_enum log_level) {
-    file_flush_level_ = log_level;
+    file_flush_level_.store(static_cast<int>(log_level),
+                            std::memory_order_relaxed);
+  }
+
+  /// 日志时间戳的秒以下精度, 以及使用本地时间还是UTC时间
+  void set_time_format(time_precision precision,
+                       time_zone zone = time_zone::local) {
+    logger.set_time_format(precision, zone);
+    cout_logger.set_time_format(precision, zone);
+  }
+
+  /// 时间戳来源, clock_source::tsc 时热路径只读 TSC, CPU 不支持时退化为
+  /// steady_clock, 参见 tsc_clock
+  void set_clock_source(clock_source source) { log_clock::set_source(source); }
+
+  /// 文件和控制台的日志格式, 如 "%T %l %v [%s:%#]", 参见 formatter
+  void set_pattern(std::string_view pattern) {
+    logger.set_pattern(pattern);
+    cout_logger.set_pattern(pattern);
+  }
+
+  /// 日志文件改为双缓冲写入, 参见 rotating_file_sink::enable_double_buffer;
+  /// 单例不会析构, 进程正常退出时由 atexit 写完缓冲区中的日志
+  void enable_file_double_buffer(
+      std::size_t buffer_size = DEFAULT_DOUBLE_BUFFER_SIZE,
+      std::chrono::milliseconds swap_timeout = DEFAULT_DOUBLE_BUFFER_TIMEOUT) {
+    logger.enable_double_buffer(buffer_size, swap_timeout);
+
+    static std::once_flag exit_flag;
+    std::call_once(exit_flag, [] {
+      std::atexit(
+          [] { log_wrapper::get_instance().disable_file_double_buffer(); });
+    });
   }
 
+  void disable_file_double_buffer() { logger.disable_double_buffer(); }
+
  private:
+  template <typename lazy_string>
+  void write_lazy_log_(const log_site& site, const lazy_string& log) {
+    small_buffer<> buffer;
+    const auto size = log.size();
+    log.save(buffer.prepare(size) + size);
+    buffer.commit(size);
+    write_log(site, buffer.view());
+  }
+
   log_wrapper() {
     logger.set_level(DEFAULT_FILE_LOG_LEVEL);
     cout_logger.set_level(DEFAULT_COUT_LOG_LEVEL);
+    extra_sinks.set_level(level_enum::off);
   }
   ~log_wrapper() = default;
   log_wrapper(const log_wrapper&) = delete;
   log_wrapper operator=(const log_wrapper&) = delete;
   log_wrapper(log_wrapper&&) = delete;
   log_wrapper operator=(log_wrapper&&) = delete;
-  void base_log(const lee::level_enum& level, const std::string& log) {
-    if (cout_logger.should_log(level)) {
-      cout_logger.log(log);
-    }
-    if (logger.should_log(level)) {
-      logger.log(log);
-    }
-    if (file_flush_level_ <= level) {
+  void base_log(const log_record& record) {
+    sinks_.log(record);
+    if (file_flush_level_.load(std::memory_order_relaxed) <=
+        static_cast<int>(record.level())) {
       logger.flush();
     }
   }
 
-  std::string get_format_log(const std::thread::id thread_id,
-                             const std::string& file_name,
-                             const std::string& func_name, const int line,
-                             const lee::level_enum& level,
-                             const std::string& log) {
-    std::ostringstream oss;
-    oss << thread_id;
-    std::string stid = oss.str();
-    std::string level_string = get_level_string(level);
-#ifdef _WIN32
-    char split = '\\';
-#else
-    char split = '/';
-#endif
-
-    std::string file = file_name;
-    if (file_name.find_last_of(split) != std::string::npos) {
-      file = file_name.substr(file_name.find_last_of(split) + 1);
-    }
-
-#ifdef USE_LAZY_STRING
-    lee::lazy_string_concat_helper<> lazy_concat;
-    std::string str_log =
-        lazy_concat + lee::get_time_string() + " " + level_string + " " + log +
-        " <In Function: " + func_name + "," + ", File: " + file +
-        " Line: " + std::to_string(line) + ", PID: " + stid + ">\n";
-#else
-    std::string str_log =
-        lee::get_time_string() + " " + level_string + " " + log +
-        " <In Function: " + func_name + ", File: " + file +
-        ", Line: " + std::to_string(line) + ", PID: " + stid + ">\n";
-#endif
-    return str_log;
-  }
-
-  std::string get_level_string(const lee::level_enum& level) {
-    std::string str("[");
-    if (level == lee::level_enum::trace) {
-      str += "trace]";
-    } else if (level == lee::level_enum::debug) {
-      str += "debug]";
-    } else if (level == lee::level_enum::info) {
-      str += "info] ";
-    } else if (level == lee::level_enum::warn) {
-      str += "warn] ";
-    } else if (level == lee::level_enum::error) {
-      str += "error]";
-    } else if (level == lee::level_enum::critical) {
-      str += "critical]";
-    } else {
-      str += "unknow]";
-    }
-    return str;
+  /// 控制台和文件两个 sink 在编译期组合, 每条日志的分发不经过虚函数;
+  /// 运行时加入的输出挂在 extra_sinks 下
+  static_logger<lee::stdout_sink<lee::default_sink_mutex>,
+                lee::rotating_file_sink<lee::default_sink_mutex>,
+                lee::dist_sink>
+      sinks_;
+  lee::stdout_sink<lee::default_sink_mutex>& cout_logger = sinks_.sink<0>();
+  lee::rotating_file_sink<lee::default_sink_mutex>& logger = sinks_.sink<1>();
+  lee::dist_sink& extra_sinks = sinks_.sink<2>();
+  /// 需持有 level_mutex_. extra_sinks 自己的等级取子 sink 的最低等级,
+  /// 没有子 sink 时为 off, static_logger 只读一次原子变量就跳过它
+  void update_min_level_() {
+    extra_sinks.set_level(extra_sinks.min_sink_level());
+    min_level_.store(std::min({static_cast<int>(logger.level()),
+                               static_cast<int>(cout_logger.level()),
+                               static_cast<int>(extra_sinks.level())}),
+                     std::memory_order_relaxed);
+    module_levels::invalidate();
   }
 
-  lee::rotating_file_sink<std::mutex> logger;
-  lee::stdout_sink<std::mutex> cout_logger;
-  lee::level_enum file_flush_level_ = lee::level_enum::info;
+  std::atomic<int> file_flush_level_{static_cast<int>(lee::level_enum::info)};
+  std::mutex level_mutex_;
+  static inline std::atomic<int> min_level_{
+      std::min(static_cast<int>(DEFAULT_FILE_LOG_LEVEL),
+               static_cast<int>(DEFAULT_COUT_LOG_LEVEL))};
+  std::mutex async_mutex_;
+  std::unique_ptr<async_backend> async_owner_;
+  std::atomic<async_backend*> async_worker_{nullptr};
 };
 }  // namespace log
 template <typename T>
 std::string to_log(const T& type) {
-  std::ostringstream stream;
-  stream << type;
-  return stream.str();
+  if constexpr (is_number_formattable<T>::value) {
+    char buf[MAX_NUMBER_SIZE];
+    return std::string(buf, format_number(buf, type));
+  } else if constexpr (is_range_formattable<T>::value) {
+    const auto limits = get_range_limits();
+    std::string res;
+    if constexpr (lee::log::detail::has_size<T>::value) {
+      /// 按每个元素8字节估算, 大多数情况下只分配一次
+      res.reserve(
+          std::min<std::size_t>(std::size(type), limits.max_elements) * 8 + 16);
+    }
+    format_value(res, type, limits);
+    return res;
+  } else {
+    std::ostringstream stream;
+    stream << type;
+    return stream.str();
+  }
 }
 
 inline std::string to_hex(const size_t dec) {
-  std::ostringstream h;
-  h << std::hex << (dec);
-  std::string result("0x");
-  result += h.str();
-  return result;
+  char buf[MAX_HEX_SIZE];
+  return std::string(buf, format_hex(buf, dec));
 }
 
 template <typename T>
 inline std::string pointer_to_hex(const T pointer) {
   static_assert(std::is_pointer<T>::value, "to_hex param is not a pointer!");
-  return lee::to_hex(reinterpret_cast<size_t>(pointer));
+  char buf[MAX_HEX_SIZE];
+  return std::string(buf, format_pointer(buf, pointer));
 }
 
-inline std::string to_log(bool x) { return x ? "true" : "false"; }
+/// to_log 的 std::pmr 版本, 结果的内存来自 resource, 如每个请求的内存池
 template <typename T>
-inline std::string to_log(T* x) {
-  return lee::pointer_to_hex(x);
+std::pmr::string to_log(const T& type, std::pmr::memory_resource* resource) {
+  std::pmr::string res(resource);
+  if constexpr (std::is_same<T, const char*>::value ||
+                std::is_same<T, char*>::value) {
+    res.append(type != nullptr ? type : "(null)");
+  } else if constexpr (is_number_formattable<T>::value) {
+    char buf[MAX_NUMBER_SIZE];
+    res.append(buf, format_number(buf, type));
+  } else if constexpr (std::is_convertible<const T&, std::string_view>::value) {
+    res.append(std::string_view(type));
+  } else if constexpr (is_range_formattable<T>::value) {
+    format_value(res, type);
+  } else {
+    std::ostringstream stream;
+    stream << type;
+    res.append(stream.str());
+  }
+  return res;
 }
 
+inline std::string to_log(bool x) { return x ? "true" : "false"; }
 template <typename T>
-inline std::string to_log(const std::vector<T>& vec) {
-  std::string res("[");
-  for (auto& it : vec) {
-    res += lee::to_log(it);
-    res += ",";
-  }
-  res.erase(std::prev(res.end()));
-  res += "]";
-  return res;
+inline std::string to_log(T* x) {
+  return lee::pointer_to_hex(x);
 }
 
 template <>
@@ -207,52 +512,201 @@ inline std::string to_log(const char* const str) {
 }
 }  // namespace lee
 
-#define LOG_TRACE(x)                                              \
-  do {                                                            \
-    std::string _log_wrapper__;                                   \
-    ::lee::log::log_wrapper::get_instance().write_log(            \
-        std::this_thread::get_id(), __FILE__, __func__, __LINE__, \
-        ::lee::level_enum::trace, (_log_wrapper__ + (x)));        \
-  } while (false)
+/// 在当前作用域定义本调用点的 static constexpr log_site
+#define LEE_LOG_SITE(name, level)                                         \
+  static constexpr ::lee::log::log_site name {                            \
+    level, ::lee::log::file_basename(__FILE__), __func__, __LINE__,       \
+        ::lee::log::make_site_id(__FILE__, __LINE__)                      \
+  }
 
-#define LOG_DEBUG(x)                                              \
-  do {                                                            \
-    std::string _log_wrapper__;                                   \
-    ::lee::log::log_wrapper::get_instance().write_log(            \
-        std::this_thread::get_id(), __FILE__, __func__, __LINE__, \
-        ::lee::level_enum::debug, (_log_wrapper__ + (x)));        \
+/// 模块等级或输出不接收该等级时只做一次比较, 不求值参数;
+/// 每个参数作为一段交给 lee::lazy_concat, 按准确长度一次拼进栈上的缓冲区.
+/// LOG_INFO("a", s, 1) 不产生中间字符串; 只有一个参数时它是一个完整的表达式,
+/// LOG_INFO("a" + s + "b") 仍会先拼出 std::string, 再复制一次
+#define LEE_LOG_WRAPPER_(level, ...)                                      \
+  do {                                                                    \
+    if (::lee::log::log_wrapper::should_log(LEE_MODULE_SITE(), level)) {  \
+      LEE_LOG_SITE(_lee_log_site__, level);                               \
+      ::lee::log::log_wrapper::get_instance().write_log(                  \
+          _lee_log_site__, ::lee::lazy_concat(__VA_ARGS__));              \
+    }                                                                     \
   } while (false)
 
-#define LOG_INFO(x)                                               \
-  do {                                                            \
-    std::string _log_wrapper__;                                   \
-    ::lee::log::log_wrapper::get_instance().write_log(            \
-        std::this_thread::get_id(), __FILE__, __func__, __LINE__, \
-        ::lee::level_enum::info, (_log_wrapper__ + (x)));         \
+/// 格式串在编译期检查; 没有输出接收该等级时参数不会被求值
+#define LEE_LOG_FMT_WRAPPER_(level, ...)                                  \
+  do {                                                                    \
+    LEE_CHECK_FORMAT(__VA_ARGS__);                                        \
+    if (::lee::log::log_wrapper::should_log(LEE_MODULE_SITE(), level)) {  \
+      LEE_LOG_SITE(_lee_log_site__, level);                               \
+      ::lee::log::log_wrapper::get_instance().write_log_fmt(              \
+          _lee_log_site__, __VA_ARGS__);                                  \
+    }                                                                     \
   } while (false)
 
-#define LOG_WARN(x)                                               \
-  do {                                                            \
-    std::string _log_wrapper__;                                   \
-    ::lee::log::log_wrapper::get_instance().write_log(            \
-        std::this_thread::get_id(), __FILE__, __func__, __LINE__, \
-        ::lee::level_enum::warn, (_log_wrapper__ + (x)));         \
+/// 与 LEE_LOG_WRAPPER_ 相同, 但写到 handle 指定的 logger;
+/// handle 是 lee::logger& 表达式, 如缓存的引用或 LEE_LOGGER("name").
+/// 先比较 logger 的等级, 再按调用点所属模块的等级过滤
+#define LEE_LOGGER_WRAPPER_(handle, level, ...)                           \
+  do {                                                                    \
+    auto &_lee_logger__ = (handle);                                       \
+    if (_lee_logger__.should_log(level) &&                                \
+        LEE_MODULE_SITE().should_log(level)) {                            \
+      LEE_LOG_SITE(_lee_log_site__, level);                               \
+      _lee_logger__.write_log(_lee_log_site__,                            \
+                              ::lee::lazy_concat(__VA_ARGS__));           \
+    }                                                                     \
   } while (false)
 
-#define LOG_ERROR(x)                                              \
-  do {                                                            \
-    std::string _log_wrapper__;                                   \
-    ::lee::log::log_wrapper::get_instance().write_log(            \
-        std::this_thread::get_id(), __FILE__, __func__, __LINE__, \
-        ::lee::level_enum::error, (_log_wrapper__ + (x)));        \
+#define LEE_LOGGER_FMT_WRAPPER_(handle, level, ...)                       \
+  do {                                                                    \
+    LEE_CHECK_FORMAT(__VA_ARGS__);                                        \
+    auto &_lee_logger__ = (handle);                                       \
+    if (_lee_logger__.should_log(level) &&                                \
+        LEE_MODULE_SITE().should_log(level)) {                            \
+      LEE_LOG_SITE(_lee_log_site__, level);                               \
+      _lee_logger__.write_log_fmt(_lee_log_site__, __VA_ARGS__);          \
+    }                                                                     \
   } while (false)
 
-#define LOG_CRITICAL(x)                                           \
-  do {                                                            \
-    std::string _log_wrapper__;                                   \
-    ::lee::log::log_wrapper::get_instance().write_log(            \
-        std::this_thread::get_id(), __FILE__, __func__, __LINE__, \
-        ::lee::level_enum::critical, (_log_wrapper__ + (x)));     \
-  } while (false)
+#if LEE_LOG_ACTIVE_LEVEL <= LEE_LOG_LEVEL_TRACE
+#define LOG_TRACE(...) LEE_LOG_WRAPPER_(::lee::level_enum::trace, __VA_ARGS__)
+#else
+#define LOG_TRACE(...) (void)0
+#endif
+
+#if LEE_LOG_ACTIVE_LEVEL <= LEE_LOG_LEVEL_TRACE
+#define LOG_TRACE_FMT(...) \
+  LEE_LOG_FMT_WRAPPER_(::lee::level_enum::trace, __VA_ARGS__)
+#else
+#define LOG_TRACE_FMT(...) (void)0
+#endif
+
+#if LEE_LOG_ACTIVE_LEVEL <= LEE_LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) LEE_LOG_WRAPPER_(::lee::level_enum::debug, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) (void)0
+#endif
+
+#if LEE_LOG_ACTIVE_LEVEL <= LEE_LOG_LEVEL_DEBUG
+#define LOG_DEBUG_FMT(...) \
+  LEE_LOG_FMT_WRAPPER_(::lee::level_enum::debug, __VA_ARGS__)
+#else
+#define LOG_DEBUG_FMT(...) (void)0
+#endif
+
+#if LEE_LOG_ACTIVE_LEVEL <= LEE_LOG_LEVEL_INFO
+#define LOG_INFO(...) LEE_LOG_WRAPPER_(::lee::level_enum::info, __VA_ARGS__)
+#else
+#define LOG_INFO(...) (void)0
+#endif
+
+#if LEE_LOG_ACTIVE_LEVEL <= LEE_LOG_LEVEL_INFO
+#define LOG_INFO_FMT(...) \
+  LEE_LOG_FMT_WRAPPER_(::lee::level_enum::info, __VA_ARGS__)
+#else
+#define LOG_INFO_FMT(...) (void)0
+#endif
+
+#if LEE_LOG_ACTIVE_LEVEL <= LEE_LOG_LEVEL_WARN
+#define LOG_WARN(...) LEE_LOG_WRAPPER_(::lee::level_enum::warn, __VA_ARGS__)
+#else
+#define LOG_WARN(...) (void)0
+#endif
+
+#if LEE_LOG_ACTIVE_LEVEL <= LEE_LOG_LEVEL_WARN
+#define LOG_WARN_FMT(...) \
+  LEE_LOG_FMT_WRAPPER_(::lee::level_enum::warn, __VA_ARGS__)
+#else
+#define LOG_WARN_FMT(...) (void)0
+#endif
+
+#if LEE_LOG_ACTIVE_LEVEL <= LEE_LOG_LEVEL_ERROR
+#define LOG_ERROR(...) LEE_LOG_WRAPPER_(::lee::level_enum::error, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) (void)0
+#endif
+
+#if LEE_LOG_ACTIVE_LEVEL <= LEE_LOG_LEVEL_ERROR
+#define LOG_ERROR_FMT(...) \
+  LEE_LOG_FMT_WRAPPER_(::lee::level_enum::error, __VA_ARGS__)
+#else
+#define LOG_ERROR_FMT(...) (void)0
+#endif
+
+#if LEE_LOG_ACTIVE_LEVEL <= LEE_LOG_LEVEL_CRITICAL
+#define LOG_CRITICAL(...) LEE_LOG_WRAPPER_(::lee::level_enum::critical, __VA_ARGS__)
+#else
+#define LOG_CRITICAL(...) (void)0
+#endif
+
+#if LEE_LOG_ACTIVE_LEVEL <= LEE_LOG_LEVEL_CRITICAL
+#define LOG_CRITICAL_FMT(...) \
+  LEE_LOG_FMT_WRAPPER_(::lee::level_enum::critical, __VA_ARGS__)
+#else
+#define LOG_CRITICAL_FMT(...) (void)0
+#endif
+
+/// 写到指定 logger 的日志宏, 如
+/// LOGGER_INFO(LEE_LOGGER("md"), "px ", px)
+
+#if LEE_LOG_ACTIVE_LEVEL <= LEE_LOG_LEVEL_TRACE
+#define LOGGER_TRACE(handle, ...) \
+  LEE_LOGGER_WRAPPER_(handle, ::lee::level_enum::trace, __VA_ARGS__)
+#define LOGGER_TRACE_FMT(handle, ...) \
+  LEE_LOGGER_FMT_WRAPPER_(handle, ::lee::level_enum::trace, __VA_ARGS__)
+#else
+#define LOGGER_TRACE(handle, ...) (void)0
+#define LOGGER_TRACE_FMT(handle, ...) (void)0
+#endif
+
+#if LEE_LOG_ACTIVE_LEVEL <= LEE_LOG_LEVEL_DEBUG
+#define LOGGER_DEBUG(handle, ...) \
+  LEE_LOGGER_WRAPPER_(handle, ::lee::level_enum::debug, __VA_ARGS__)
+#define LOGGER_DEBUG_FMT(handle, ...) \
+  LEE_LOGGER_FMT_WRAPPER_(handle, ::lee::level_enum::debug, __VA_ARGS__)
+#else
+#define LOGGER_DEBUG(handle, ...) (void)0
+#define LOGGER_DEBUG_FMT(handle, ...) (void)0
+#endif
+
+#if LEE_LOG_ACTIVE_LEVEL <= LEE_LOG_LEVEL_INFO
+#define LOGGER_INFO(handle, ...) \
+  LEE_LOGGER_WRAPPER_(handle, ::lee::level_enum::info, __VA_ARGS__)
+#define LOGGER_INFO_FMT(handle, ...) \
+  LEE_LOGGER_FMT_WRAPPER_(handle, ::lee::level_enum::info, __VA_ARGS__)
+#else
+#define LOGGER_INFO(handle, ...) (void)0
+#define LOGGER_INFO_FMT(handle, ...) (void)0
+#endif
+
+#if LEE_LOG_ACTIVE_LEVEL <= LEE_LOG_LEVEL_WARN
+#define LOGGER_WARN(handle, ...) \
+  LEE_LOGGER_WRAPPER_(handle, ::lee::level_enum::warn, __VA_ARGS__)
+#define LOGGER_WARN_FMT(handle, ...) \
+  LEE_LOGGER_FMT_WRAPPER_(handle, ::lee::level_enum::warn, __VA_ARGS__)
+#else
+#define LOGGER_WARN(handle, ...) (void)0
+#define LOGGER_WARN_FMT(handle, ...) (void)0
+#endif
+
+#if LEE_LOG_ACTIVE_LEVEL <= LEE_LOG_LEVEL_ERROR
+#define LOGGER_ERROR(handle, ...) \
+  LEE_LOGGER_WRAPPER_(handle, ::lee::level_enum::error, __VA_ARGS__)
+#define LOGGER_ERROR_FMT(handle, ...) \
+  LEE_LOGGER_FMT_WRAPPER_(handle, ::lee::level_enum::error, __VA_ARGS__)
+#else
+#define LOGGER_ERROR(handle, ...) (void)0
+#define LOGGER_ERROR_FMT(handle, ...) (void)0
+#endif
+
+#if LEE_LOG_ACTIVE_LEVEL <= LEE_LOG_LEVEL_CRITICAL
+#define LOGGER_CRITICAL(handle, ...) \
+  LEE_LOGGER_WRAPPER_(handle, ::lee::level_enum::critical, __VA_ARGS__)
+#define LOGGER_CRITICAL_FMT(handle, ...) \
+  LEE_LOGGER_FMT_WRAPPER_(handle, ::lee::level_enum::critical, __VA_ARGS__)
+#else
+#define LOGGER_CRITICAL(handle, ...) (void)0
+#define LOGGER_CRITICAL_FMT(handle, ...) (void)0
+#endif
 
 #endif
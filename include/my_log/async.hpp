@@ -0,0 +1,347 @@
+///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
+/// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
+///
+/// Use of this source code is governed by a MIT license
+/// that can be found in the License file.
+///
+/// @file   async.hpp
+/// @brief  异步日志用的有界队列与后台写线程
+///
+/// @author lijiancong, pipinstall@163.com
+/// @date   2026-10-17 09:12:40
+///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
+
+#ifndef INCLUDE_MY_LOG_ASYNC_HPP_
+#define INCLUDE_MY_LOG_ASYNC_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "my_log/log.hpp"
+
+namespace lee {
+inline namespace log {
+/// 默认异步队列长度(条)
+constexpr std::size_t DEFAULT_ASYNC_QUEUE_SIZE = 8192;
+
+/// 队列满时的处理策略
+enum class overflow_policy {
+  block,            ///< 阻塞生产者直到队列有空位
+  drop_newest,      ///< 丢弃正在写入的这一条
+  overwrite_oldest  ///< 覆盖队列中最旧的一条
+};
+
+/// 异步模式的后台实现
+enum class async_mode {
+  shared_queue,  ///< 所有线程共用一个有界队列
+  thread_ring    ///< 每个线程一个无锁环形队列, 后台按时间戳归并
+};
+
+/// 各个策略下被阻塞/丢弃的条数
+struct overflow_counters {
+  std::size_t blocked = 0;
+  std::size_t dropped_newest = 0;
+  std::size_t overwritten_oldest = 0;
+};
+
+enum class async_msg_type { log, flush, terminate };
+
+/// 队列中的一条记录, 保存生成 log_record 所需的全部信息
+struct async_msg {
+  async_msg_type type = async_msg_type::log;
+  level_enum level = level_enum::off;
+  const log_site *site = nullptr;  ///< 日志宏定义的静态对象, 一直有效
+  log_clock::time_stamp time;
+  std::shared_ptr<const thread_identity> thread;
+  std::string msg;  ///< 用户写的日志内容, 未格式化
+
+  /// 只在本对象存活期间有效
+  log_record record() const {
+    log_record result;
+    result.site = site;
+    result.time = time;
+    result.thread = thread.get();
+    result.payload = msg;
+    return result;
+  }
+};
+
+/// @name     async_backend
+/// @brief    异步模式的后台实现接口, log_wrapper 只通过它投递记录
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 10:20:11
+/// @warning  线程安全
+class async_backend {
+ public:
+  virtual ~async_backend() = default;
+  /// 返回假表示已经 stop, 记录没有被接收, 调用方应改为同步写入;
+  /// 按溢出策略丢弃的记录也算已处理
+  virtual bool post_log(async_msg &&msg) = 0;
+  virtual void post_flush() = 0;
+  /// 写完已投递的记录后停止后台线程, 可重复调用; 因队列满而等待的生产者
+  /// 会被唤醒, 它们的 post_log 返回假
+  virtual void stop() = 0;
+  virtual overflow_counters counters() = 0;
+
+  /// 只带等级和内容的记录
+  bool post_log(level_enum level, std::string &&msg) {
+    async_msg m;
+    m.level = level;
+    m.msg = std::move(msg);
+    return post_log(std::move(m));
+  }
+};
+
+/// @name     circular_q
+/// @brief    定长的环形缓冲区, 满了之后再写入会覆盖最旧的元素
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 09:13:02
+/// @warning  线程不安全
+template <typename T>
+class circular_q {
+ public:
+  explicit circular_q(std::size_t max_items)
+      : max_items_(max_items + 1), v_(max_items_) {}
+
+  /// 满了就覆盖最旧的元素, 返回是否发生了覆盖
+  bool push_back(T &&item) {
+    v_[tail_] = std::move(item);
+    tail_ = (tail_ + 1) % max_items_;
+    if (tail_ == head_) {
+      head_ = (head_ + 1) % max_items_;
+      return true;
+    }
+    return false;
+  }
+
+  T &front() { return v_[head_]; }
+
+  void pop_front() { head_ = (head_ + 1) % max_items_; }
+
+  std::size_t size() const {
+    return tail_ >= head_ ? tail_ - head_ : max_items_ - (head_ - tail_);
+  }
+
+  bool empty() const { return tail_ == head_; }
+
+  bool full() const { return ((tail_ + 1) % max_items_) == head_; }
+
+ private:
+  std::size_t max_items_ = 0;
+  std::size_t head_ = 0;
+  std::size_t tail_ = 0;
+  std::vector<T> v_;
+};
+
+/// @name     mpmc_blocking_queue
+/// @brief    多生产者的有界队列, 满时按 overflow_policy 处理
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 09:14:31
+/// @warning  线程安全
+template <typename T>
+class mpmc_blocking_queue {
+ public:
+  explicit mpmc_blocking_queue(std::size_t max_items) : q_(max_items) {}
+
+  /// @name     enqueue
+  /// @brief    写入一条记录
+  ///
+  /// @param    item    [in]  记录
+  /// @param    policy  [in]  队列满时的处理策略
+  ///
+  /// @return   记录是否进入了队列(drop_newest 时可能被丢弃, close 之后
+  ///           一律拒绝)
+  ///
+  /// @author   Lijiancong, pipinstall@163.com
+  /// @date     2026-10-17 09:15:10
+  /// @warning  线程安全
+  bool enqueue(T &&item, overflow_policy policy) {
+    {
+      std::unique_lock<std::mutex> lock(queue_mutex_);
+      if (closed_) {
+        return false;
+      }
+      if (q_.full()) {
+        if (policy == overflow_policy::drop_newest) {
+          ++counters_.dropped_newest;
+          return false;
+        }
+        if (policy == overflow_policy::block) {
+          ++counters_.blocked;
+          pop_cv_.wait(lock,
+                       [this] { return closed_ || !this->q_.full(); });
+          if (closed_) {
+            return false;
+          }
+        }
+      }
+      if (q_.push_back(std::move(item))) {
+        ++counters_.overwritten_oldest;
+      }
+    }
+    push_cv_.notify_one();
+    return true;
+  }
+
+  /// @name     dequeue_for
+  /// @brief    取出一条记录, 最多等待 wait_duration
+  ///
+  /// @param    popped_item   [out] 取出的记录
+  /// @param    wait_duration [in]  最长等待时间
+  ///
+  /// @return   取到记录则返回真
+  ///
+  /// @author   Lijiancong, pipinstall@163.com
+  /// @date     2026-10-17 09:16:44
+  /// @warning  线程安全
+  bool dequeue_for(T &popped_item, std::chrono::milliseconds wait_duration) {
+    {
+      std::unique_lock<std::mutex> lock(queue_mutex_);
+      if (!push_cv_.wait_for(lock, wait_duration,
+                             [this] { return !this->q_.empty(); })) {
+        return false;
+      }
+      popped_item = std::move(q_.front());
+      q_.pop_front();
+    }
+    pop_cv_.notify_one();
+    return true;
+  }
+
+  /// @name     close
+  /// @brief    之后的 enqueue 都被拒绝, 等待空间的生产者被唤醒并返回假;
+  ///           last 是最后一条进入队列的记录, 队列满时等消费者腾出空间
+  ///
+  /// @param    last  [in]  最后一条记录, 如结束消费线程的记录
+  ///
+  /// @return   NONE
+  ///
+  /// @author   Lijiancong, pipinstall@163.com
+  /// @date     2026-10-17 09:17:25
+  /// @warning  线程安全; 只能调用一次
+  void close(T &&last) {
+    {
+      std::unique_lock<std::mutex> lock(queue_mutex_);
+      closed_ = true;
+      pop_cv_.notify_all();
+      pop_cv_.wait(lock, [this] { return !this->q_.full(); });
+      q_.push_back(std::move(last));
+    }
+    push_cv_.notify_one();
+  }
+
+  bool closed() {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    return closed_;
+  }
+
+  std::size_t size() {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    return q_.size();
+  }
+
+  overflow_counters counters() {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    return counters_;
+  }
+
+ private:
+  std::mutex queue_mutex_;
+  std::condition_variable push_cv_;
+  std::condition_variable pop_cv_;
+  circular_q<T> q_;
+  overflow_counters counters_;
+  bool closed_ = false;
+};
+
+/// @name     async_worker
+/// @brief    持有有界队列和一个后台线程, 后台线程把记录交给 handler 落盘
+/// @details  析构或 stop() 时关闭队列并写入最后一条 terminate 记录, 然后
+///           等待后台线程退出. 队列是先进先出的, 所以 terminate 之前的记录
+///           都会被写完, 之后的记录被拒绝.
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 09:18:20
+/// @warning  线程安全
+class async_worker final : public async_backend {
+ public:
+  using handler_t = std::function<void(const async_msg &)>;
+
+  async_worker(std::size_t queue_size, overflow_policy policy,
+               handler_t handler)
+      : policy_(policy), q_(queue_size), handler_(std::move(handler)) {
+    thread_ = std::thread([this] {
+      while (process_next_msg_()) {
+      }
+    });
+  }
+
+  ~async_worker() override { stop(); }
+
+  async_worker(const async_worker &) = delete;
+  async_worker &operator=(const async_worker &) = delete;
+
+  using async_backend::post_log;
+
+  bool post_log(async_msg &&msg) override {
+    /// 关闭后 closed_ 不会再变回假, 据此区分被丢弃和被拒绝
+    return q_.enqueue(std::move(msg), policy_) || !q_.closed();
+  }
+
+  void post_flush() override {
+    async_msg m;
+    m.type = async_msg_type::flush;
+    q_.enqueue(std::move(m), overflow_policy::block);
+  }
+
+  void stop() override {
+    std::lock_guard<std::mutex> lock(stop_mutex_);
+    if (!thread_.joinable()) {
+      return;
+    }
+    async_msg m;
+    m.type = async_msg_type::terminate;
+    /// 结束记录不能被丢弃, 也不能覆盖别的记录
+    q_.close(std::move(m));
+    thread_.join();
+  }
+
+  overflow_counters counters() override { return q_.counters(); }
+
+  std::size_t queue_size() { return q_.size(); }
+
+ private:
+  bool process_next_msg_() {
+    async_msg msg;
+    if (!q_.dequeue_for(msg, std::chrono::seconds(10))) {
+      return true;
+    }
+    if (msg.type == async_msg_type::terminate) {
+      return false;
+    }
+    handler_(msg);
+    return true;
+  }
+
+  overflow_policy policy_;
+  mpmc_blocking_queue<async_msg> q_;
+  handler_t handler_;
+  std::mutex stop_mutex_;
+  std::thread thread_;
+};
+}  // namespace log
+}  // namespace lee
+
+#endif  // INCLUDE_MY_LOG_ASYNC_HPP_
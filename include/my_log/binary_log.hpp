@@ -0,0 +1,633 @@
+///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
+/// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
+///
+/// Use of this source code is governed by a MIT license
+/// that can be found in the License file.
+///
+/// @file   binary_log.hpp
+/// @brief  二进制日志: 热路径只把调用点编号、时间戳和参数原始字节放进本线程
+///         的暂存队列, 由写线程写入文件, 离线解码器(my_log_decoder)还原成
+///         文本日志
+///
+/// @author lijiancong, pipinstall@163.com
+/// @date   2026-10-17 13:15:08
+///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
+
+#ifndef INCLUDE_MY_LOG_BINARY_LOG_HPP_
+#define INCLUDE_MY_LOG_BINARY_LOG_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "my_log/file_helper.hpp"
+#include "my_log/format_number.hpp"
+#include "my_log/log.hpp"
+#include "my_log/os.hpp"
+#include "my_log/thread_ring.hpp"
+
+namespace lee {
+inline namespace log {
+/// 文件格式
+/// 文件头:   "LEEBLOG1" + uint32 字节序标记(0x01020304)
+/// 调用点:   uint8(site) uint32 id uint8 level int32 line
+///           uint16+file uint16+func uint16+format
+/// 日志记录: uint8(record) uint32 id int64 时间(纳秒) uint32 线程号 uint8 参数个数
+///           每个参数: uint8 类型 + 数据
+/// 每个文件都会重新写入用到的调用点, 单个文件可以独立解码.
+constexpr char BINARY_LOG_MAGIC[] = "LEEBLOG1";
+constexpr std::uint32_t BINARY_LOG_ENDIAN_MARK = 0x01020304;
+
+/// 暂存队列中一条记录最多的字节数, 更长的记录由调用线程直接写入文件
+constexpr std::size_t BINARY_CHUNK_SIZE = 224;
+/// 每个线程暂存队列的长度(条)
+constexpr std::size_t DEFAULT_BINARY_RING_SIZE = 1024;
+/// 写线程没有取到记录时的休眠时间
+constexpr std::chrono::microseconds BINARY_WRITER_IDLE_SLEEP(500);
+
+enum class binary_entry : std::uint8_t { site = 1, record = 2 };
+
+enum class binary_arg : std::uint8_t {
+  int64 = 1,
+  uint64,
+  float64,
+  boolean,
+  character,
+  string,
+  pointer
+};
+
+/// @name     binary_site
+/// @brief    一个 LOG_BINARY 调用点的静态信息, 第一次使用时分配编号
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 13:16:40
+/// @warning  线程安全
+struct binary_site {
+  level_enum level;
+  const char *format;
+  const char *file;
+  const char *func;
+  int line;
+  std::atomic<std::uint32_t> id{0};
+};
+
+namespace detail {
+template <typename T>
+inline void put_raw(std::vector<char> &buf, const T &value) {
+  const auto offset = buf.size();
+  buf.resize(offset + sizeof(T));
+  std::memcpy(&buf[offset], &value, sizeof(T));
+}
+
+inline void put_string(std::vector<char> &buf, const char *str,
+                       std::size_t len) {
+  if (len > UINT16_MAX) {
+    len = UINT16_MAX;
+  }
+  put_raw(buf, static_cast<std::uint16_t>(len));
+  buf.insert(buf.end(), str, str + len);
+}
+
+inline void encode_arg(std::vector<char> &buf, bool value) {
+  put_raw(buf, binary_arg::boolean);
+  put_raw(buf, static_cast<std::uint8_t>(value));
+}
+
+inline void encode_arg(std::vector<char> &buf, char value) {
+  put_raw(buf, binary_arg::character);
+  put_raw(buf, value);
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value &&
+                               std::is_signed<T>::value>::type
+encode_arg(std::vector<char> &buf, T value) {
+  put_raw(buf, binary_arg::int64);
+  put_raw(buf, static_cast<std::int64_t>(value));
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value &&
+                               std::is_unsigned<T>::value>::type
+encode_arg(std::vector<char> &buf, T value) {
+  put_raw(buf, binary_arg::uint64);
+  put_raw(buf, static_cast<std::uint64_t>(value));
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value>::type
+encode_arg(std::vector<char> &buf, T value) {
+  put_raw(buf, binary_arg::float64);
+  put_raw(buf, static_cast<double>(value));
+}
+
+inline void encode_arg(std::vector<char> &buf, const char *value) {
+  put_raw(buf, binary_arg::string);
+  put_string(buf, value, std::strlen(value));
+}
+
+inline void encode_arg(std::vector<char> &buf, const std::string &value) {
+  put_raw(buf, binary_arg::string);
+  put_string(buf, value.data(), value.size());
+}
+
+template <typename T>
+inline void encode_arg(std::vector<char> &buf, const T *value) {
+  put_raw(buf, binary_arg::pointer);
+  put_raw(buf, static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(
+                   static_cast<const void *>(value))));
+}
+
+inline void encode_args(std::vector<char> &) {}
+
+template <typename T, typename... Args>
+inline void encode_args(std::vector<char> &buf, const T &first,
+                        const Args &... rest) {
+  encode_arg(buf, first);
+  encode_args(buf, rest...);
+}
+
+/// 二进制日志里的线程号, 与文本日志的 TID 相同, 每个线程只取一次
+inline std::uint32_t binary_thread_id() {
+  thread_local const auto tid = static_cast<std::uint32_t>(thread_id());
+  return tid;
+}
+
+/// 暂存在线程队列中的一条已编码的记录
+struct binary_chunk {
+  std::int64_t timestamp;  ///< 与记录中的时间相同, 写线程据此归并
+  std::uint64_t sequence;
+  const binary_site *site;
+  std::uint32_t size;
+  char data[BINARY_CHUNK_SIZE];
+};
+}  // namespace detail
+
+/// @name     binary_logger
+/// @brief    二进制日志文件, 按大小滚动
+/// @details  生产者在本线程的 per_thread_rings 队列中暂存编码好的记录, 不加锁
+///           也不调用 fwrite; 写线程按时间归并各线程的记录后写入文件.
+///           记录超过 BINARY_CHUNK_SIZE、本线程的队列已满或写线程已停止时,
+///           调用线程加锁先写完所有暂存的记录再写这一条, 同一线程的记录不会
+///           乱序. flush() 同样先写完暂存的记录.
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 13:21:55
+/// @warning  线程安全; 单例在进程正常退出时由 atexit 停止写线程
+class binary_logger {
+ public:
+  static binary_logger &get_instance() {
+    static std::once_flag flag;
+    static binary_logger *instance = nullptr;
+    std::call_once(flag, [&]() {
+      instance = new binary_logger();
+      std::atexit([] { binary_logger::get_instance().stop(); });
+    });
+    return *instance;
+  }
+
+  explicit binary_logger(
+      std::string base_filename = std::string("log/binary/binary_log.bin"),
+      std::size_t max_size = 1048576 * 50, std::size_t max_files = 10,
+      std::size_t ring_size = DEFAULT_BINARY_RING_SIZE)
+      : base_filename_(std::move(base_filename)),
+        max_size_(max_size),
+        max_files_(max_files),
+        rings_(ring_size) {
+    /// 与 rotating_file_sink 一样不覆盖已有的日志, 上次运行(如崩溃前)留下的
+    /// 文件先滚动到 .1, 新文件仍从文件头开始, 可以独立解码
+    file_helper_.open(base_filename_);
+    const bool has_previous = file_helper_.size() > 0;
+    if (has_previous) {
+      rotate_();
+    } else {
+      open_file_();
+    }
+    writer_ = std::thread([this] { writer_loop_(); });
+    staging_.store(true, std::memory_order_release);
+  }
+
+  ~binary_logger() { stop(); }
+
+  binary_logger(const binary_logger &) = delete;
+  binary_logger &operator=(const binary_logger &) = delete;
+
+  /// @name     log
+  /// @brief    写入一条二进制日志, 格式化推迟到解码时进行
+  ///
+  /// @param    site  [in]  调用点
+  /// @param    args  [in]  格式串中 {} 对应的参数
+  ///
+  /// @return   NONE
+  ///
+  /// @author   Lijiancong, pipinstall@163.com
+  /// @date     2026-10-17 13:23:30
+  /// @warning  线程安全
+  template <typename... Args>
+  void log(binary_site &site, const char * /* format */,
+           const Args &... args) {
+    static_assert(sizeof...(Args) <= UINT8_MAX, "too many arguments");
+    if (!should_log(site.level)) {
+      return;
+    }
+    auto id = site.id.load(std::memory_order_acquire);
+    if (id == 0) {
+      id = register_site_(site);
+    }
+    const auto now = static_cast<std::int64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch())
+            .count());
+    thread_local std::vector<char> buf;
+    buf.clear();
+    detail::put_raw(buf, binary_entry::record);
+    detail::put_raw(buf, id);
+    detail::put_raw(buf, now);
+    detail::put_raw(buf, detail::binary_thread_id());
+    detail::put_raw(buf, static_cast<std::uint8_t>(sizeof...(Args)));
+    detail::encode_args(buf, args...);
+
+    if (buf.size() <= BINARY_CHUNK_SIZE &&
+        staging_.load(std::memory_order_acquire)) {
+      auto &slot = rings_.local();
+      detail::binary_chunk chunk;
+      chunk.timestamp = now;
+      chunk.sequence = slot.sequence++;
+      chunk.site = &site;
+      chunk.size = static_cast<std::uint32_t>(buf.size());
+      std::memcpy(chunk.data, buf.data(), buf.size());
+      if (slot.ring.try_push(std::move(chunk))) {
+        return;
+      }
+      slot.blocked.store(slot.blocked.load(std::memory_order_relaxed) + 1,
+                         std::memory_order_relaxed);
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    drain_();
+    write_record_(site, buf.data(), buf.size());
+  }
+
+  /// 写完所有线程暂存的记录并刷新文件
+  void flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    drain_();
+    file_helper_.flush();
+  }
+
+  /// @name     stop
+  /// @brief    停止写线程并写完暂存的记录, 之后的日志由调用线程直接写入
+  ///
+  /// @return   NONE
+  ///
+  /// @author   Lijiancong, pipinstall@163.com
+  /// @date     2026-10-17 13:26:41
+  /// @warning  线程安全
+  void stop() {
+    std::lock_guard<std::mutex> stop_lock(stop_mutex_);
+    staging_.store(false, std::memory_order_release);
+    if (writer_.joinable()) {
+      stop_writer_.store(true, std::memory_order_release);
+      writer_.join();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    drain_();
+    file_helper_.flush();
+  }
+
+  /// 队列满后由调用线程直接写入的条数
+  std::size_t staging_overflows() { return rings_.counters().blocked; }
+
+  inline bool should_log(level_enum msg_level) const {
+    return static_cast<int>(msg_level) >=
+           level_.load(std::memory_order_relaxed);
+  }
+
+  void set_level(level_enum log_level) {
+    level_.store(static_cast<int>(log_level), std::memory_order_relaxed);
+  }
+
+  std::string filename() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return file_helper_.filename();
+  }
+
+ private:
+  std::uint32_t register_site_(binary_site &site) {
+    std::lock_guard<std::mutex> lock(sites_mutex_);
+    auto id = site.id.load(std::memory_order_relaxed);
+    if (id == 0) {
+      id = ++site_count_;
+      site.id.store(id, std::memory_order_release);
+    }
+    return id;
+  }
+
+  /// 需持有 mutex_. 先滚动再写调用点, 保证记录和它的调用点在同一个文件里
+  void write_record_(const binary_site &site, const char *data,
+                     std::size_t size) {
+    if (current_size_ > max_size_) {
+      rotate_();
+    }
+    const auto id = site.id.load(std::memory_order_relaxed);
+    if (id >= emitted_.size() || !emitted_[id]) {
+      write_site_(site, id);
+    }
+    write_(data, size);
+  }
+
+  /// 需持有 mutex_. 按时间归并写完所有线程暂存的记录, 返回写入的条数
+  std::size_t drain_() {
+    rings_.refresh(snapshot_, generation_);
+    const auto count =
+        rings_t::drain(snapshot_, [this](detail::binary_chunk &chunk) {
+          write_record_(*chunk.site, chunk.data, chunk.size);
+        });
+    rings_t::recycle(snapshot_);
+    return count;
+  }
+
+  void writer_loop_() {
+    for (;;) {
+      /// 先读停止标志, 保证停止前暂存的记录都在本轮被写完
+      const bool stopping = stop_writer_.load(std::memory_order_acquire);
+      std::size_t count = 0;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        count = drain_();
+      }
+      if (stopping) {
+        return;
+      }
+      if (count == 0) {
+        std::this_thread::sleep_for(BINARY_WRITER_IDLE_SLEEP);
+      }
+    }
+  }
+
+  /// 需持有 mutex_
+  void write_site_(const binary_site &site, std::uint32_t id) {
+    thread_local std::vector<char> buf;
+    buf.clear();
+    detail::put_raw(buf, binary_entry::site);
+    detail::put_raw(buf, id);
+    detail::put_raw(buf, static_cast<std::uint8_t>(site.level));
+    detail::put_raw(buf, static_cast<std::int32_t>(site.line));
+    detail::put_string(buf, site.file, std::strlen(site.file));
+    detail::put_string(buf, site.func, std::strlen(site.func));
+    detail::put_string(buf, site.format, std::strlen(site.format));
+    write_(buf.data(), buf.size());
+    if (id >= emitted_.size()) {
+      emitted_.resize(id + 1, false);
+    }
+    emitted_[id] = true;
+  }
+
+  /// 需持有 mutex_
+  void write_(const char *data, std::size_t size) {
+    file_helper_.write(data, size);
+    current_size_ += size;
+  }
+
+  void open_file_() {
+    file_helper_.open(base_filename_, true);
+    file_helper_.write(BINARY_LOG_MAGIC, sizeof(BINARY_LOG_MAGIC) - 1);
+    std::uint32_t mark = BINARY_LOG_ENDIAN_MARK;
+    file_helper_.write(reinterpret_cast<const char *>(&mark), sizeof(mark));
+    current_size_ = sizeof(BINARY_LOG_MAGIC) - 1 + sizeof(mark);
+    emitted_.assign(emitted_.size(), false);
+  }
+
+  /// 与 rotating_file_sink 相同的滚动方式, 新文件会重新写入调用点
+  void rotate_() {
+    file_helper_.close();
+    for (auto i = max_files_; i > 0; --i) {
+      std::string src =
+          rotating_file_sink<std::mutex>::calc_filename(base_filename_, i - 1);
+      if (!path_exists(src)) {
+        continue;
+      }
+      std::string target =
+          rotating_file_sink<std::mutex>::calc_filename(base_filename_, i);
+      (void)lee::os::remove(target);
+      (void)lee::os::rename(src, target);
+    }
+    open_file_();
+  }
+
+  std::string base_filename_;
+  std::size_t max_size_;
+  std::size_t max_files_;
+  std::size_t current_size_ = 0;
+  file_helper file_helper_;
+  std::vector<bool> emitted_;  ///< 当前文件中已写入的调用点
+  std::mutex mutex_;
+
+  using rings_t = per_thread_rings<detail::binary_chunk>;
+  rings_t rings_;
+  rings_t::snapshot_t snapshot_;  ///< 需持有 mutex_
+  std::size_t generation_ = 0;    ///< 需持有 mutex_
+  std::atomic<bool> staging_{false};
+  std::atomic<bool> stop_writer_{false};
+  std::mutex stop_mutex_;
+  std::thread writer_;
+
+  std::mutex sites_mutex_;
+  std::uint32_t site_count_ = 0;
+  std::atomic<int> level_{static_cast<int>(level_enum::trace)};
+};
+
+/// @name     binary_decoder
+/// @brief    把二进制日志还原成与 log_wrapper 相同格式的文本
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 13:30:12
+/// @warning  线程不安全
+class binary_decoder {
+ public:
+  /// @name     decode
+  /// @brief    解码一个二进制日志文件
+  ///
+  /// @param    in  [in]  二进制日志
+  /// @param    out [out] 文本日志
+  ///
+  /// @return   解码出的日志条数, 文件格式错误时抛出 std::runtime_error
+  ///
+  /// @author   Lijiancong, pipinstall@163.com
+  /// @date     2026-10-17 13:31:48
+  /// @warning  线程不安全
+  std::size_t decode(std::istream &in, std::ostream &out) {
+    char magic[sizeof(BINARY_LOG_MAGIC) - 1];
+    in.read(magic, sizeof(magic));
+    if (!in || std::memcmp(magic, BINARY_LOG_MAGIC, sizeof(magic)) != 0) {
+      throw std::runtime_error("not a binary log file");
+    }
+    if (get_<std::uint32_t>(in) != BINARY_LOG_ENDIAN_MARK) {
+      throw std::runtime_error("binary log written with another byte order");
+    }
+    sites_.clear();
+    std::size_t count = 0;
+    for (;;) {
+      std::uint8_t type = 0;
+      if (!in.read(reinterpret_cast<char *>(&type), 1)) {
+        return count;
+      }
+      if (type == static_cast<std::uint8_t>(binary_entry::site)) {
+        read_site_(in);
+      } else if (type == static_cast<std::uint8_t>(binary_entry::record)) {
+        read_record_(in, out);
+        ++count;
+      } else {
+        throw std::runtime_error("corrupted binary log entry");
+      }
+    }
+  }
+
+ private:
+  struct site_info {
+    level_enum level;
+    int line;
+    std::string file;
+    std::string func;
+    std::string format;
+  };
+
+  template <typename T>
+  static T get_(std::istream &in) {
+    T value;
+    if (!in.read(reinterpret_cast<char *>(&value), sizeof(T))) {
+      throw std::runtime_error("truncated binary log");
+    }
+    return value;
+  }
+
+  static std::string get_string_(std::istream &in) {
+    std::string str(get_<std::uint16_t>(in), '\0');
+    if (!str.empty() && !in.read(&str[0], str.size())) {
+      throw std::runtime_error("truncated binary log");
+    }
+    return str;
+  }
+
+  void read_site_(std::istream &in) {
+    auto id = get_<std::uint32_t>(in);
+    site_info site;
+    site.level = static_cast<level_enum>(get_<std::uint8_t>(in));
+    site.line = get_<std::int32_t>(in);
+    site.file = get_string_(in);
+    auto pos = site.file.find_last_of("/\\");
+    if (pos != std::string::npos) {
+      site.file = site.file.substr(pos + 1);
+    }
+    site.func = get_string_(in);
+    site.format = get_string_(in);
+    sites_[id] = std::move(site);
+  }
+
+  static std::string read_arg_(std::istream &in) {
+    std::ostringstream oss;
+    switch (static_cast<binary_arg>(get_<std::uint8_t>(in))) {
+      case binary_arg::int64:
+        return std::to_string(get_<std::int64_t>(in));
+      case binary_arg::uint64:
+        return std::to_string(get_<std::uint64_t>(in));
+      case binary_arg::float64: {
+        /// 与文本日志相同的最短往返表示, 不丢精度
+        char buf[MAX_FLOAT_SIZE];
+        return std::string(buf, format_float(buf, get_<double>(in)));
+      }
+      case binary_arg::boolean:
+        return get_<std::uint8_t>(in) ? "true" : "false";
+      case binary_arg::character:
+        return std::string(1, get_<char>(in));
+      case binary_arg::string:
+        return get_string_(in);
+      case binary_arg::pointer:
+        oss << "0x" << std::hex << get_<std::uint64_t>(in);
+        return oss.str();
+      default:
+        throw std::runtime_error("corrupted binary log argument");
+    }
+  }
+
+  /// 按顺序把参数填入 {}, {{ 和 }} 表示字面的花括号
+  static std::string apply_format_(const std::string &format,
+                                   const std::vector<std::string> &args) {
+    std::string result;
+    std::size_t next_arg = 0;
+    for (std::size_t i = 0; i < format.size(); ++i) {
+      const char c = format[i];
+      if (c == '{' && i + 1 < format.size() && format[i + 1] == '{') {
+        result += '{';
+        ++i;
+      } else if (c == '}' && i + 1 < format.size() && format[i + 1] == '}') {
+        result += '}';
+        ++i;
+      } else if (c == '{' && i + 1 < format.size() && format[i + 1] == '}') {
+        if (next_arg < args.size()) {
+          result += args[next_arg++];
+        }
+        ++i;
+      } else {
+        result += c;
+      }
+    }
+    return result;
+  }
+
+  void read_record_(std::istream &in, std::ostream &out) {
+    auto id = get_<std::uint32_t>(in);
+    auto nanoseconds = get_<std::int64_t>(in);
+    auto tid = get_<std::uint32_t>(in);
+    auto argc = get_<std::uint8_t>(in);
+    std::vector<std::string> args;
+    for (std::uint8_t i = 0; i < argc; ++i) {
+      args.push_back(read_arg_(in));
+    }
+    auto it = sites_.find(id);
+    if (it == sites_.end()) {
+      throw std::runtime_error("binary log record refers to unknown site");
+    }
+    const auto &site = it->second;
+    std::chrono::system_clock::time_point time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::nanoseconds(nanoseconds)));
+    out << lee::get_time_string(time_point) << " "
+        << get_level_string(site.level) << " "
+        << apply_format_(site.format, args)
+        << " <In Function: " << site.func << ", File: " << site.file
+        << ", Line: " << site.line << ", TID: " << tid << ">\n";
+  }
+
+  std::unordered_map<std::uint32_t, site_info> sites_;
+};
+}  // namespace log
+}  // namespace lee
+
+/// 用法: LOG_BINARY(info, "took {} ms, ret: {}", elapsed, ret);
+/// 格式串必须是字符串字面量, 参数只支持算术类型、字符串和指针
+#define LOG_BINARY(level, ...)                                              \
+  do {                                                                      \
+    if constexpr (::lee::log::level_compiled_in(::lee::level_enum::level)) { \
+      static ::lee::log::binary_site _lee_binary_site__{                    \
+          ::lee::level_enum::level, LEE_FIRST_ARG(__VA_ARGS__),             \
+          LEE_FILE_BASENAME, __func__, __LINE__};                           \
+      ::lee::log::binary_logger::get_instance().log(_lee_binary_site__,     \
+                                                    __VA_ARGS__);           \
+    }                                                                       \
+  } while (false)
+
+#endif  // INCLUDE_MY_LOG_BINARY_LOG_HPP_
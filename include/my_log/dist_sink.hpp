@@ -0,0 +1,170 @@
+///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
+/// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
+///
+/// Use of this source code is governed by a MIT license
+/// that can be found in the License file.
+///
+/// @file   dist_sink.hpp
+/// @brief  运行时可增删子 sink 的分发 sink, 写日志时不加锁
+///
+/// @author lijiancong, pipinstall@163.com
+/// @date   2026-10-17 22:40:05
+///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
+
+#ifndef INCLUDE_MY_LOG_DIST_SINK_HPP_
+#define INCLUDE_MY_LOG_DIST_SINK_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "my_log/epoch.hpp"
+#include "my_log/log.hpp"
+
+namespace lee {
+inline namespace log {
+/// @name     dist_sink
+/// @brief    把每条日志转发给一组子 sink, 每个子 sink 按自己的等级过滤.
+///           子 sink 列表是不可修改的快照, 写日志时在 epoch_domain 的临界区
+///           内读取当前快照, 不加锁; 增删子 sink 时复制一份新快照, 原子地换上,
+///           旧快照等正在使用它的日志调用都结束后才释放.
+/// @details  被移除的子 sink 由快照中的 shared_ptr 持有, 因此也会等到这些
+///           调用结束后才析构. 子 sink 自己的线程安全由它的 Mutex 保证.
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 22:46:31
+/// @warning  线程安全; 子 sink 的 log 中不能再修改同一个 dist_sink
+class dist_sink final : public sink {
+ public:
+  using sink_ptr = std::shared_ptr<sink>;
+
+  dist_sink() : current_(new snapshot()) {}
+
+  explicit dist_sink(std::vector<sink_ptr> sinks)
+      : current_(new snapshot{std::move(sinks)}) {}
+
+  /// 析构时不能再有其他线程通过它写日志
+  ~dist_sink() override {
+    delete current_.load(std::memory_order_relaxed);
+    for (const auto &it : retired_) {
+      delete it.snap;
+    }
+  }
+
+  dist_sink(const dist_sink &) = delete;
+  dist_sink &operator=(const dist_sink &) = delete;
+
+  void log(const log_record &record) override {
+    epoch_domain::guard guard(epoch_domain::global());
+    const auto level = record.level();
+    for (const auto &child : current_.load(std::memory_order_seq_cst)->sinks) {
+      if (child->should_log(level)) {
+        child->log(record);
+      }
+    }
+  }
+
+  void flush() override {
+    epoch_domain::guard guard(epoch_domain::global());
+    for (const auto &child : current_.load(std::memory_order_seq_cst)->sinks) {
+      child->flush();
+    }
+  }
+
+  /// 子 sink 中最低的等级, 没有子 sink 时为 level_enum::off
+  level_enum min_sink_level() const {
+    epoch_domain::guard guard(epoch_domain::global());
+    auto result = level_enum::off;
+    for (const auto &child : current_.load(std::memory_order_seq_cst)->sinks) {
+      result = std::min(result, child->level());
+    }
+    return result;
+  }
+
+  /// 当前子 sink 的一份拷贝
+  std::vector<sink_ptr> sinks() const {
+    epoch_domain::guard guard(epoch_domain::global());
+    return current_.load(std::memory_order_seq_cst)->sinks;
+  }
+
+  void add_sink(sink_ptr child) {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    auto next = std::make_unique<snapshot>(*current_.load(std::memory_order_relaxed));
+    next->sinks.push_back(std::move(child));
+    publish_(std::move(next));
+  }
+
+  /// 子 sink 不在列表中时返回假
+  bool remove_sink(const sink_ptr &child) {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    const auto &sinks = current_.load(std::memory_order_relaxed)->sinks;
+    const auto it = std::find(sinks.begin(), sinks.end(), child);
+    if (it == sinks.end()) {
+      return false;
+    }
+    auto next = std::make_unique<snapshot>();
+    next->sinks.reserve(sinks.size() - 1);
+    next->sinks.insert(next->sinks.end(), sinks.begin(), it);
+    next->sinks.insert(next->sinks.end(), it + 1, sinks.end());
+    publish_(std::move(next));
+    return true;
+  }
+
+  void set_sinks(std::vector<sink_ptr> sinks) {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    publish_(std::make_unique<snapshot>(snapshot{std::move(sinks)}));
+  }
+
+  /// 释放已经没有读者的旧快照, 返回仍在等待的个数.
+  /// 每次修改时都会尝试一次, 修改之后长时间不再修改时可以手动调用
+  std::size_t reclaim() {
+    std::lock_guard<std::mutex> lock(writer_mutex_);
+    reclaim_();
+    return retired_.size();
+  }
+
+ private:
+  struct snapshot {
+    std::vector<sink_ptr> sinks;
+  };
+
+  struct retired_snapshot {
+    const snapshot *snap;
+    std::uint64_t epoch;  ///< 换下时的 epoch, 见 epoch_domain::retire
+  };
+
+  /// 需持有 writer_mutex_
+  void publish_(std::unique_ptr<snapshot> next) {
+    retired_.reserve(retired_.size() + 1);
+    const snapshot *old =
+        current_.exchange(next.release(), std::memory_order_seq_cst);
+    retired_.push_back({old, epoch_domain::global().retire()});
+    reclaim_();
+  }
+
+  /// 需持有 writer_mutex_
+  void reclaim_() {
+    auto &domain = epoch_domain::global();
+    const auto end = std::remove_if(
+        retired_.begin(), retired_.end(), [&domain](const retired_snapshot &it) {
+          if (!domain.can_reclaim(it.epoch)) {
+            return false;
+          }
+          delete it.snap;
+          return true;
+        });
+    retired_.erase(end, retired_.end());
+  }
+
+  std::atomic<const snapshot *> current_;
+  std::mutex writer_mutex_;
+  std::vector<retired_snapshot> retired_;  ///< 受 writer_mutex_ 保护
+};
+}  // namespace log
+}  // namespace lee
+
+#endif  // INCLUDE_MY_LOG_DIST_SINK_HPP_
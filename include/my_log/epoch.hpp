@@ -0,0 +1,147 @@
+///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
+/// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
+///
+/// Use of this source code is governed by a MIT license
+/// that can be found in the License file.
+///
+/// @file   epoch.hpp
+/// @brief  基于 epoch 的内存回收: 读者无锁, 写者确认没有旧读者后才释放
+///
+/// @author lijiancong, pipinstall@163.com
+/// @date   2026-10-17 22:31:16
+///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
+
+#ifndef INCLUDE_MY_LOG_EPOCH_HPP_
+#define INCLUDE_MY_LOG_EPOCH_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+
+#include "my_log/mutex.hpp"
+
+namespace lee {
+inline namespace log {
+/// @name     epoch_domain
+/// @brief    读者进入时在自己的槽里登记当前的 epoch, 离开时清零; 写者换掉
+///           共享指针后推进 epoch, 旧对象在所有登记的 epoch 都大于它退休时的
+///           epoch 之后才能释放.
+/// @details  每个线程第一次读时占用一个槽, 线程退出时归还, 槽本身不释放.
+///           登记和读取指针都用 seq_cst, 保证写者扫描时看不到的读者一定会
+///           读到新的指针.
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 22:34:02
+/// @warning  线程安全; 读者的临界区内不能等待写者
+class epoch_domain {
+  /// 每个槽独占一个缓存行, 读者登记时不会让其他线程的槽失效
+  struct alignas(CACHE_LINE_SIZE) slot {
+    std::atomic<std::uint64_t> epoch{0};  ///< 0 表示不在临界区
+    std::atomic<bool> in_use{false};
+    slot *next = nullptr;
+  };
+
+  struct local_state {
+    slot *own = nullptr;
+    int depth = 0;
+  };
+
+ public:
+  /// 全进程共用一个 domain
+  static epoch_domain &global() {
+    static epoch_domain *instance = new epoch_domain();
+    return *instance;
+  }
+
+  /// 读者临界区, 可以嵌套, 只有最外层登记
+  class guard {
+   public:
+    explicit guard(epoch_domain &domain) : local_(domain.local_()) {
+      if (local_.depth++ == 0) {
+        local_.own->epoch.store(
+            domain.epoch_.load(std::memory_order_seq_cst),
+            std::memory_order_seq_cst);
+      }
+    }
+    ~guard() {
+      if (--local_.depth == 0) {
+        local_.own->epoch.store(0, std::memory_order_release);
+      }
+    }
+    guard(const guard &) = delete;
+    guard &operator=(const guard &) = delete;
+
+   private:
+    local_state &local_;
+  };
+
+  /// 写者换掉指针之后调用, 返回旧对象的退休 epoch
+  std::uint64_t retire() {
+    return epoch_.fetch_add(1, std::memory_order_seq_cst);
+  }
+
+  /// 退休 epoch 为 retired 的对象现在是否可以释放
+  bool can_reclaim(std::uint64_t retired) const {
+    return min_active_() > retired;
+  }
+
+ private:
+  /// 线程退出时归还槽
+  struct local_holder {
+    explicit local_holder(epoch_domain &domain) {
+      state.own = domain.acquire_slot_();
+    }
+    ~local_holder() {
+      state.own->epoch.store(0, std::memory_order_release);
+      state.own->in_use.store(false, std::memory_order_release);
+    }
+    local_state state;
+  };
+
+  epoch_domain() = default;
+
+  local_state &local_() {
+    /// 只有 global() 一个实例, thread_local 不需要区分 domain
+    thread_local local_holder holder(*this);
+    return holder.state;
+  }
+
+  slot *acquire_slot_() {
+    for (slot *it = slots_.load(std::memory_order_acquire); it != nullptr;
+         it = it->next) {
+      bool expected = false;
+      if (!it->in_use.load(std::memory_order_relaxed) &&
+          it->in_use.compare_exchange_strong(expected, true,
+                                             std::memory_order_acquire)) {
+        return it;
+      }
+    }
+    slot *fresh = new slot();
+    fresh->in_use.store(true, std::memory_order_relaxed);
+    fresh->next = slots_.load(std::memory_order_relaxed);
+    while (!slots_.compare_exchange_weak(fresh->next, fresh,
+                                         std::memory_order_release,
+                                         std::memory_order_relaxed)) {
+    }
+    return fresh;
+  }
+
+  std::uint64_t min_active_() const {
+    auto result = std::numeric_limits<std::uint64_t>::max();
+    for (slot *it = slots_.load(std::memory_order_acquire); it != nullptr;
+         it = it->next) {
+      const auto epoch = it->epoch.load(std::memory_order_seq_cst);
+      if (epoch != 0 && epoch < result) {
+        result = epoch;
+      }
+    }
+    return result;
+  }
+
+  std::atomic<std::uint64_t> epoch_{1};
+  std::atomic<slot *> slots_{nullptr};
+};
+}  // namespace log
+}  // namespace lee
+
+#endif  // INCLUDE_MY_LOG_EPOCH_HPP_
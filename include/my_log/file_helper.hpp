@@ -119,9 +119,20 @@ class file_helper {
   /// @author   Lijiancong, pipinstall@163.com
   /// @date     2020-07-18 16:05:29
   /// @warning  线程不安全
-  inline void write(const std::string &buf) {
-    size_t msg_size = buf.size();
-    auto data = buf.data();
+  inline void write(const std::string &buf) { write(buf.data(), buf.size()); }
+
+  /// @name     write
+  /// @brief    向文件中写入一段内存
+  ///
+  /// @param    data      [in]  要写入的数据
+  /// @param    msg_size  [in]  数据长度
+  ///
+  /// @return   NONE
+  ///
+  /// @author   Lijiancong, pipinstall@163.com
+  /// @date     2026-10-17 13:10:52
+  /// @warning  线程不安全
+  inline void write(const char *data, size_t msg_size) {
     if (std::fwrite(data, 1, msg_size, fd_) != msg_size) {
       throw("Failed writing to file " + (filename_));
     }
@@ -0,0 +1,199 @@
+///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
+/// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
+///
+/// Use of this source code is governed by a MIT license
+/// that can be found in the License file.
+///
+/// @file   format_number.hpp
+/// @brief  不分配内存、不依赖 locale 的数字格式化, 直接写入调用者的缓冲区
+///
+/// @author lijiancong, pipinstall@163.com
+/// @date   2026-10-17 18:50:14
+///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
+
+#ifndef INCLUDE_MY_LOG_FORMAT_NUMBER_HPP_
+#define INCLUDE_MY_LOG_FORMAT_NUMBER_HPP_
+
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#include "my_log/timestamp.hpp"
+
+namespace lee {
+inline namespace log {
+/// 整数最长的输出: 20位数字加符号
+constexpr std::size_t MAX_INT_SIZE = 24;
+/// 浮点数最长的输出(long double 的最短表示也不会超过)
+constexpr std::size_t MAX_FLOAT_SIZE = 64;
+/// 十六进制最长的输出: "0x" 加16位
+constexpr std::size_t MAX_HEX_SIZE = 20;
+/// 任意算术类型或指针最长的输出
+constexpr std::size_t MAX_NUMBER_SIZE = MAX_FLOAT_SIZE;
+
+namespace detail {
+/// 十进制位数, 只做比较不做除法
+inline int count_digits(std::uint64_t n) {
+  int count = 1;
+  for (;;) {
+    if (n < 10) return count;
+    if (n < 100) return count + 1;
+    if (n < 1000) return count + 2;
+    if (n < 10000) return count + 3;
+    n /= 10000u;
+    count += 4;
+  }
+}
+}  // namespace detail
+
+/// @name     format_int
+/// @brief    整数格式化, 每次查表输出两位
+///
+/// @param    out   [out] 至少 MAX_INT_SIZE 字节
+/// @param    value [in]  任意整数类型(bool 和字符类型除外)
+///
+/// @return   写入内容的末尾
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 18:52:40
+/// @warning  线程安全
+template <typename T>
+inline char *format_int(char *out, T value) {
+  static_assert(std::is_integral<T>::value, "format_int needs an integer");
+  using unsigned_t = std::make_unsigned_t<T>;
+  auto abs = static_cast<std::uint64_t>(static_cast<unsigned_t>(value));
+  if constexpr (std::is_signed<T>::value) {
+    if (value < 0) {
+      *out++ = '-';
+      /// 先转成无符号再取负, 最小值也不会溢出
+      abs = static_cast<unsigned_t>(unsigned_t(0) -
+                                    static_cast<unsigned_t>(value));
+    }
+  }
+  char *end = out + detail::count_digits(abs);
+  char *p = end;
+  while (abs >= 100) {
+    p -= 2;
+    std::memcpy(p, &os::detail::DIGITS_TABLE[(abs % 100) * 2], 2);
+    abs /= 100;
+  }
+  if (abs < 10) {
+    *--p = static_cast<char>('0' + abs);
+  } else {
+    p -= 2;
+    std::memcpy(p, &os::detail::DIGITS_TABLE[abs * 2], 2);
+  }
+  return end;
+}
+
+/// @name     format_float
+/// @brief    浮点数的最短往返表示, 读回来与原值完全相等
+///
+/// @param    out   [out] 至少 MAX_FLOAT_SIZE 字节
+/// @param    value [in]  float/double/long double
+///
+/// @return   写入内容的末尾
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 18:55:06
+/// @warning  线程安全
+template <typename T>
+inline char *format_float(char *out, T value) {
+  static_assert(std::is_floating_point<T>::value,
+                "format_float needs a floating point type");
+  return std::to_chars(out, out + MAX_FLOAT_SIZE, value).ptr;
+}
+
+/// 浮点数按固定小数位数输出, 如 precision 为2时 3.14159 输出 "3.14";
+/// 整数部分超出 MAX_FLOAT_SIZE 时退回最短表示
+template <typename T>
+inline char *format_float(char *out, T value, int precision) {
+  static_assert(std::is_floating_point<T>::value,
+                "format_float needs a floating point type");
+  auto result = std::to_chars(out, out + MAX_FLOAT_SIZE, value,
+                              std::chars_format::fixed, precision);
+  if (result.ec != std::errc()) {
+    return format_float(out, value);
+  }
+  return result.ptr;
+}
+
+/// @name     format_hex
+/// @brief    无符号整数以 "0x" 开头的小写十六进制输出
+///
+/// @param    out   [out] 至少 MAX_HEX_SIZE 字节
+/// @param    value [in]  数值
+///
+/// @return   写入内容的末尾
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 18:57:31
+/// @warning  线程安全
+inline char *format_hex(char *out, std::uint64_t value) {
+  constexpr char HEX_DIGITS[] = "0123456789abcdef";
+  *out++ = '0';
+  *out++ = 'x';
+  int digits = 1;
+  for (auto rest = value >> 4; rest != 0; rest >>= 4) {
+    ++digits;
+  }
+  char *end = out + digits;
+  for (char *p = end; p != out; value >>= 4) {
+    *--p = HEX_DIGITS[value & 0xf];
+  }
+  return end;
+}
+
+/// 指针(含函数指针)以十六进制输出
+template <typename T>
+inline char *format_pointer(char *out, T pointer) {
+  static_assert(std::is_pointer<T>::value, "format_pointer needs a pointer");
+  return format_hex(out, static_cast<std::uint64_t>(
+                             reinterpret_cast<std::uintptr_t>(pointer)));
+}
+
+/// @name     format_number
+/// @brief    按类型选择上面的格式化函数; bool 输出 true/false, 字符类型原样输出
+///
+/// @param    out   [out] 至少 MAX_NUMBER_SIZE 字节
+/// @param    value [in]  算术类型或指针
+///
+/// @return   写入内容的末尾
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 19:00:12
+/// @warning  线程安全
+template <typename T>
+inline char *format_number(char *out, T value) {
+  if constexpr (std::is_same<T, bool>::value) {
+    const char *text = value ? "true" : "false";
+    const auto n = value ? 4 : 5;
+    std::memcpy(out, text, n);
+    return out + n;
+  } else if constexpr (std::is_same<T, char>::value ||
+                       std::is_same<T, signed char>::value ||
+                       std::is_same<T, unsigned char>::value) {
+    *out = static_cast<char>(value);
+    return out + 1;
+  } else if constexpr (std::is_integral<T>::value) {
+    return format_int(out, value);
+  } else if constexpr (std::is_floating_point<T>::value) {
+    return format_float(out, value);
+  } else {
+    static_assert(std::is_pointer<T>::value,
+                  "format_number needs an arithmetic or pointer type");
+    return format_pointer(out, value);
+  }
+}
+
+/// format_number 能处理的类型
+template <typename T>
+struct is_number_formattable
+    : std::integral_constant<bool, std::is_arithmetic<T>::value ||
+                                       std::is_pointer<T>::value> {};
+}  // namespace log
+}  // namespace lee
+
+#endif  // INCLUDE_MY_LOG_FORMAT_NUMBER_HPP_
@@ -0,0 +1,220 @@
+///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
+/// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
+///
+/// Use of this source code is governed by a MIT license
+/// that can be found in the License file.
+///
+/// @file   format_range.hpp
+/// @brief  容器、pair/tuple、optional 的格式化, 元素个数和嵌套层数有上限
+///
+/// @author lijiancong, pipinstall@163.com
+/// @date   2026-10-17 19:20:33
+///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
+
+#ifndef INCLUDE_MY_LOG_FORMAT_RANGE_HPP_
+#define INCLUDE_MY_LOG_FORMAT_RANGE_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "my_log/format_number.hpp"
+
+namespace lee {
+inline namespace log {
+/// 默认每个容器最多输出的元素个数
+constexpr std::size_t DEFAULT_RANGE_MAX_ELEMENTS = 100;
+/// 默认最多展开的嵌套层数
+constexpr std::size_t DEFAULT_RANGE_MAX_DEPTH = 4;
+
+/// 容器输出的上限
+struct range_limits {
+  std::size_t max_elements = DEFAULT_RANGE_MAX_ELEMENTS;
+  std::size_t max_depth = DEFAULT_RANGE_MAX_DEPTH;
+};
+
+namespace detail {
+inline std::atomic<std::size_t> &range_max_elements() {
+  static std::atomic<std::size_t> value{DEFAULT_RANGE_MAX_ELEMENTS};
+  return value;
+}
+
+inline std::atomic<std::size_t> &range_max_depth() {
+  static std::atomic<std::size_t> value{DEFAULT_RANGE_MAX_DEPTH};
+  return value;
+}
+
+template <typename T, typename = void>
+struct is_range : std::false_type {};
+template <typename T>
+struct is_range<T, std::void_t<decltype(std::begin(std::declval<const T &>())),
+                               decltype(std::end(std::declval<const T &>()))>>
+    : std::true_type {};
+
+template <typename T, typename = void>
+struct is_map : std::false_type {};
+template <typename T>
+struct is_map<T, std::void_t<typename T::key_type, typename T::mapped_type>>
+    : is_range<T> {};
+
+template <typename T, typename = void>
+struct is_tuple_like : std::false_type {};
+template <typename T>
+struct is_tuple_like<T, std::void_t<decltype(std::tuple_size<T>::value)>>
+    : std::true_type {};
+
+template <typename T>
+struct is_optional : std::false_type {};
+template <typename T>
+struct is_optional<std::optional<T>> : std::true_type {};
+
+template <typename T, typename = void>
+struct has_size : std::false_type {};
+template <typename T>
+struct has_size<T, std::void_t<decltype(std::size(std::declval<const T &>()))>>
+    : std::true_type {};
+
+template <typename Out>
+inline void append_text(Out &out, std::string_view text) {
+  out.append(text.data(), text.size());
+}
+
+template <typename Out, typename T>
+void append_value(Out &out, const T &value, std::size_t depth,
+                  const range_limits &limits);
+
+template <typename Out, typename Tuple, std::size_t... I>
+void append_tuple(Out &out, const Tuple &value, std::size_t depth,
+                  const range_limits &limits, std::index_sequence<I...>) {
+  out.push_back('(');
+  ((I == 0 ? void() : out.push_back(','),
+    append_value(out, std::get<I>(value), depth + 1, limits)),
+   ...);
+  out.push_back(')');
+}
+
+template <typename Out, typename Range>
+void append_range(Out &out, const Range &range, std::size_t depth,
+                  const range_limits &limits) {
+  constexpr bool map = is_map<Range>::value;
+  if (depth >= limits.max_depth) {
+    append_text(out, map ? "{...}" : "[...]");
+    return;
+  }
+  out.push_back(map ? '{' : '[');
+  auto it = std::begin(range);
+  const auto end = std::end(range);
+  std::size_t count = 0;
+  for (; it != end && count < limits.max_elements; ++it, ++count) {
+    if (count != 0) {
+      out.push_back(',');
+    }
+    if constexpr (map) {
+      append_value(out, it->first, depth + 1, limits);
+      out.push_back(':');
+      append_value(out, it->second, depth + 1, limits);
+    } else {
+      append_value(out, *it, depth + 1, limits);
+    }
+  }
+  if (it != end) {
+    std::size_t rest = 0;
+    if constexpr (has_size<Range>::value) {
+      rest = static_cast<std::size_t>(std::size(range)) - count;
+    } else {
+      rest = static_cast<std::size_t>(std::distance(it, end));
+    }
+    append_text(out, count != 0 ? ",... +" : "... +");
+    char buf[MAX_INT_SIZE];
+    out.append(buf, static_cast<std::size_t>(format_int(buf, rest) - buf));
+    append_text(out, " more");
+  }
+  out.push_back(map ? '}' : ']');
+}
+
+template <typename Out, typename T>
+void append_value(Out &out, const T &value, std::size_t depth,
+                  const range_limits &limits) {
+  if constexpr (std::is_same<T, const char *>::value ||
+                std::is_same<T, char *>::value) {
+    append_text(out, value != nullptr ? std::string_view(value)
+                                      : std::string_view("(null)"));
+  } else if constexpr (is_number_formattable<T>::value) {
+    char buf[MAX_NUMBER_SIZE];
+    out.append(buf, static_cast<std::size_t>(format_number(buf, value) - buf));
+  } else if constexpr (std::is_convertible<const T &, std::string_view>::value) {
+    append_text(out, std::string_view(value));
+  } else if constexpr (is_optional<T>::value) {
+    if (value) {
+      append_value(out, *value, depth, limits);
+    } else {
+      append_text(out, "none");
+    }
+  } else if constexpr (is_range<T>::value) {
+    append_range(out, value, depth, limits);
+  } else if constexpr (is_tuple_like<T>::value) {
+    append_tuple(out, value, depth, limits,
+                 std::make_index_sequence<std::tuple_size<T>::value>());
+  } else {
+    std::ostringstream stream;
+    stream << value;
+    append_text(out, stream.str());
+  }
+}
+}  // namespace detail
+
+/// 设置容器输出的上限, 对之后所有的 to_log / log_stream 生效
+inline void set_range_limits(const range_limits &limits) {
+  detail::range_max_elements().store(limits.max_elements,
+                                     std::memory_order_relaxed);
+  detail::range_max_depth().store(limits.max_depth, std::memory_order_relaxed);
+}
+
+inline range_limits get_range_limits() {
+  range_limits limits;
+  limits.max_elements =
+      detail::range_max_elements().load(std::memory_order_relaxed);
+  limits.max_depth = detail::range_max_depth().load(std::memory_order_relaxed);
+  return limits;
+}
+
+/// 容器、pair/tuple 或 optional, 由 format_value 处理而不是 std::ostream
+template <typename T>
+struct is_range_formattable
+    : std::integral_constant<
+          bool, !std::is_convertible<const T &, std::string_view>::value &&
+                    (detail::is_range<T>::value ||
+                     detail::is_tuple_like<T>::value ||
+                     detail::is_optional<T>::value)> {};
+
+/// @name     format_value
+/// @brief    把一个值追加到 out 的末尾. 容器输出为 [1,2,3], 关联容器为
+///           {k:v,...}, pair/tuple 为 (a,b), 空的 optional 为 none;
+///           超出上限的元素输出为 "... +N more", 超出层数的输出为 [...]
+///
+/// @param    out     [out] std::string 或其他有 append(const char*, n)
+///                         和 push_back(char) 的缓冲区
+/// @param    value   [in]  要输出的值
+/// @param    limits  [in]  元素个数和嵌套层数的上限
+///
+/// @return   NONE
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 19:31:18
+/// @warning  线程安全
+template <typename Out, typename T>
+inline void format_value(Out &out, const T &value,
+                         const range_limits &limits = get_range_limits()) {
+  detail::append_value(out, value, 0, limits);
+}
+}  // namespace log
+}  // namespace lee
+
+#endif  // INCLUDE_MY_LOG_FORMAT_RANGE_HPP_
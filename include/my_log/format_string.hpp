@@ -0,0 +1,307 @@
+///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
+/// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
+///
+/// Use of this source code is governed by a MIT license
+/// that can be found in the License file.
+///
+/// @file   format_string.hpp
+/// @brief  "{}" 风格的格式串: 编译期按参数类型检查, 运行时一遍格式化
+///
+/// @author lijiancong, pipinstall@163.com
+/// @date   2026-10-17 19:50:02
+///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
+
+#ifndef INCLUDE_MY_LOG_FORMAT_STRING_HPP_
+#define INCLUDE_MY_LOG_FORMAT_STRING_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "my_log/format_number.hpp"
+#include "my_log/format_range.hpp"
+#include "my_log/log.hpp"
+
+namespace lee {
+inline namespace log {
+/// 格式串检查的结果
+enum class format_error {
+  none,
+  too_few_args,       ///< 参数比 {} 少
+  too_many_args,      ///< 参数比 {} 多
+  unmatched_brace,    ///< 单独的 { 或 }, 字面量请写 {{ 和 }}
+  bad_spec,           ///< 不支持的格式说明, 只支持 {} {:x} {:.N} {:.Nf}
+  hex_needs_integer,  ///< {:x} 只能用于整数和指针
+  precision_needs_float,  ///< {:.N} 只能用于浮点数
+  unformattable_arg       ///< 参数既不是内置类型、字符串、容器, 也没有 operator<<
+};
+
+template <typename... Args>
+struct type_list {};
+
+namespace detail {
+/// 只用于 decltype, 得到参数类型而不对参数求值
+template <typename... Args>
+type_list<std::decay_t<Args>...> arg_types(const Args &...);
+
+enum class arg_kind { integer, floating, pointer, other, unformattable };
+
+template <typename T, typename = void>
+struct is_streamable : std::false_type {};
+template <typename T>
+struct is_streamable<T, std::void_t<decltype(std::declval<std::ostream &>()
+                                             << std::declval<const T &>())>>
+    : std::true_type {};
+
+template <typename T>
+constexpr arg_kind kind_of() {
+  if constexpr (std::is_same<T, bool>::value || std::is_same<T, char>::value ||
+                std::is_same<T, signed char>::value ||
+                std::is_same<T, unsigned char>::value ||
+                std::is_same<T, const char *>::value ||
+                std::is_same<T, char *>::value) {
+    return arg_kind::other;
+  } else if constexpr (std::is_integral<T>::value) {
+    return arg_kind::integer;
+  } else if constexpr (std::is_floating_point<T>::value) {
+    return arg_kind::floating;
+  } else if constexpr (std::is_pointer<T>::value) {
+    return arg_kind::pointer;
+  } else if constexpr (std::is_convertible<const T &, std::string_view>::value ||
+                       is_range_formattable<T>::value ||
+                       is_streamable<T>::value) {
+    return arg_kind::other;
+  } else {
+    return arg_kind::unformattable;
+  }
+}
+
+/// 一个 {} 的格式说明
+struct format_spec {
+  bool hex = false;
+  int precision = -1;
+};
+
+/// 解析 "{" 之后到 "}" 为止的内容, pos 指向 "{" 之后, 返回 "}" 之后的位置;
+/// 格式错误时返回 npos
+constexpr std::size_t parse_spec(std::string_view fmt, std::size_t pos,
+                                 format_spec &spec) {
+  if (pos < fmt.size() && fmt[pos] == '}') {
+    return pos + 1;
+  }
+  if (pos >= fmt.size() || fmt[pos] != ':') {
+    return std::string_view::npos;
+  }
+  ++pos;
+  if (pos < fmt.size() && fmt[pos] == 'x') {
+    spec.hex = true;
+    ++pos;
+  } else if (pos < fmt.size() && fmt[pos] == '.') {
+    ++pos;
+    int precision = 0;
+    const auto digits_begin = pos;
+    while (pos < fmt.size() && fmt[pos] >= '0' && fmt[pos] <= '9' &&
+           pos - digits_begin < 2) {
+      precision = precision * 10 + (fmt[pos] - '0');
+      ++pos;
+    }
+    if (pos == digits_begin) {
+      return std::string_view::npos;
+    }
+    if (pos < fmt.size() && fmt[pos] == 'f') {
+      ++pos;
+    }
+    spec.precision = precision;
+  }
+  if (pos < fmt.size() && fmt[pos] == '}') {
+    return pos + 1;
+  }
+  return std::string_view::npos;
+}
+
+/// 检查格式串与各个参数的类型是否匹配
+constexpr format_error check_format(std::string_view fmt,
+                                    const arg_kind *kinds, std::size_t count) {
+  for (std::size_t i = 0; i < count; ++i) {
+    if (kinds[i] == arg_kind::unformattable) {
+      return format_error::unformattable_arg;
+    }
+  }
+  std::size_t next_arg = 0;
+  for (std::size_t i = 0; i < fmt.size();) {
+    if (fmt[i] == '}') {
+      if (i + 1 < fmt.size() && fmt[i + 1] == '}') {
+        i += 2;
+        continue;
+      }
+      return format_error::unmatched_brace;
+    }
+    if (fmt[i] != '{') {
+      ++i;
+      continue;
+    }
+    if (i + 1 < fmt.size() && fmt[i + 1] == '{') {
+      i += 2;
+      continue;
+    }
+    format_spec spec;
+    const auto end = parse_spec(fmt, i + 1, spec);
+    if (end == std::string_view::npos) {
+      /// 区分缺少 "}" 和说明写错
+      for (auto j = i + 1; j < fmt.size(); ++j) {
+        if (fmt[j] == '}') {
+          return format_error::bad_spec;
+        }
+      }
+      return format_error::unmatched_brace;
+    }
+    if (next_arg == count) {
+      return format_error::too_few_args;
+    }
+    const auto kind = kinds[next_arg++];
+    if (spec.hex && kind != arg_kind::integer && kind != arg_kind::pointer) {
+      return format_error::hex_needs_integer;
+    }
+    if (spec.precision >= 0 && kind != arg_kind::floating) {
+      return format_error::precision_needs_float;
+    }
+    i = end;
+  }
+  return next_arg == count ? format_error::none : format_error::too_many_args;
+}
+
+template <typename List>
+struct format_checker;
+
+/// 第一个类型是格式串本身
+template <typename Format, typename... Args>
+struct format_checker<type_list<Format, Args...>> {
+  static constexpr format_error check(std::string_view fmt) {
+    constexpr arg_kind kinds[sizeof...(Args) + 1] = {kind_of<Args>()...,
+                                                     arg_kind::other};
+    return check_format(fmt, kinds, sizeof...(Args));
+  }
+};
+
+template <typename Out, typename T>
+void append_arg(Out &out, const void *arg, const format_spec &spec) {
+  const T &value = *static_cast<const T *>(arg);
+  if constexpr (std::is_pointer<T>::value &&
+                !std::is_same<T, const char *>::value &&
+                !std::is_same<T, char *>::value) {
+    char buf[MAX_HEX_SIZE];
+    out.append(buf, static_cast<std::size_t>(format_pointer(buf, value) - buf));
+    (void)spec;
+  } else if constexpr (std::is_integral<T>::value &&
+                       !std::is_same<T, bool>::value) {
+    char buf[MAX_NUMBER_SIZE];
+    char *end = spec.hex ? format_hex(buf, static_cast<std::uint64_t>(
+                                               static_cast<std::make_unsigned_t<T>>(
+                                                   value)))
+                         : format_number(buf, value);
+    out.append(buf, static_cast<std::size_t>(end - buf));
+  } else if constexpr (std::is_floating_point<T>::value) {
+    char buf[MAX_FLOAT_SIZE];
+    char *end = spec.precision >= 0 ? format_float(buf, value, spec.precision)
+                                    : format_float(buf, value);
+    out.append(buf, static_cast<std::size_t>(end - buf));
+  } else {
+    (void)spec;
+    format_value(out, value);
+  }
+}
+
+template <typename Out>
+struct format_arg {
+  void (*append)(Out &, const void *, const format_spec &);
+  const void *value;
+};
+}  // namespace detail
+
+/// @name     assert_format
+/// @brief    把 check_format 的结果变成带说明的编译错误
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 19:58:44
+/// @warning  NONE
+template <format_error E>
+struct assert_format {
+  static_assert(E != format_error::too_few_args,
+                "format string has more {} than arguments");
+  static_assert(E != format_error::too_many_args,
+                "format string has fewer {} than arguments");
+  static_assert(E != format_error::unmatched_brace,
+                "unmatched { or } in format string, use {{ and }} for literals");
+  static_assert(E != format_error::bad_spec,
+                "unsupported format spec, use {} {:x} {:.N} or {:.Nf}");
+  static_assert(E != format_error::hex_needs_integer,
+                "{:x} needs an integer or pointer argument");
+  static_assert(E != format_error::precision_needs_float,
+                "{:.N} needs a floating point argument");
+  static_assert(E != format_error::unformattable_arg,
+                "argument type has no formatter and no operator<<");
+  static constexpr bool value = true;
+};
+
+/// @name     format_to
+/// @brief    按格式串把参数一遍写入 out 的末尾; 格式串应已通过 check_format,
+///           多出来的 {} 原样输出
+///
+/// @param    out   [out] std::string 或有 append(const char*, n) 和
+///                       push_back(char) 的缓冲区
+/// @param    fmt   [in]  格式串
+/// @param    args  [in]  参数
+///
+/// @return   NONE
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 20:02:19
+/// @warning  线程安全
+template <typename Out, typename... Args>
+void format_to(Out &out, std::string_view fmt, const Args &...args) {
+  const detail::format_arg<Out> table[sizeof...(Args) + 1] = {
+      {&detail::append_arg<Out, Args>, static_cast<const void *>(&args)}...,
+      {nullptr, nullptr}};
+  std::size_t next_arg = 0;
+  std::size_t literal_begin = 0;
+  for (std::size_t i = 0; i < fmt.size();) {
+    const char c = fmt[i];
+    if ((c == '{' || c == '}') && i + 1 < fmt.size() && fmt[i + 1] == c) {
+      out.append(fmt.data() + literal_begin, i + 1 - literal_begin);
+      i += 2;
+      literal_begin = i;
+      continue;
+    }
+    if (c != '{') {
+      ++i;
+      continue;
+    }
+    detail::format_spec spec;
+    const auto end = detail::parse_spec(fmt, i + 1, spec);
+    if (end == std::string_view::npos || next_arg == sizeof...(Args)) {
+      ++i;
+      continue;
+    }
+    out.append(fmt.data() + literal_begin, i - literal_begin);
+    const auto &arg = table[next_arg++];
+    arg.append(out, arg.value, spec);
+    i = end;
+    literal_begin = i;
+  }
+  out.append(fmt.data() + literal_begin, fmt.size() - literal_begin);
+}
+}  // namespace log
+}  // namespace lee
+
+/// 在编译期检查格式串与参数, 不对参数求值; 第一个参数必须是字符串字面量
+#define LEE_CHECK_FORMAT(...)                                             \
+  static_assert(                                                          \
+      ::lee::log::assert_format<::lee::log::detail::format_checker<       \
+          decltype(::lee::log::detail::arg_types(__VA_ARGS__))>::check(   \
+          LEE_FIRST_ARG(__VA_ARGS__))>::value,                            \
+      "")
+
+#endif  // INCLUDE_MY_LOG_FORMAT_STRING_HPP_
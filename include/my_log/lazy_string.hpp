@@ -1,5 +1,4 @@
-﻿
-///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
+﻿///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
 /// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
 ///
 /// Use of this source code is governed by a MIT license
@@ -15,42 +14,112 @@
 #ifndef INCLUDE_MY_LOG_LAZY_STRING_HPP_
 #define INCLUDE_MY_LOG_LAZY_STRING_HPP_
 
-#include <algorithm>
+#include <cstddef>
+#include <cstring>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+#include "my_log/format_number.hpp"
 
 namespace lee {
 inline namespace string {
-template <typename... Strings>
+namespace detail {
+/// 数字和字符在拼接时就格式化好, 放在节点自己的空间里
+template <std::size_t N>
+class formatted_piece {
+ public:
+  template <typename T>
+  explicit formatted_piece(T value)
+      : size_(static_cast<std::size_t>(format_number(data_, value) - data_)) {}
+
+  const char *data() const { return data_; }
+  std::size_t size() const { return size_; }
+
+ private:
+  char data_[N];
+  std::size_t size_;
+};
+
+/// 字符串只保存指针和长度, 不复制
+template <typename T, typename = void>
+struct lazy_piece {};
+
+template <typename T>
+struct lazy_piece<
+    T, std::enable_if_t<std::is_convertible<const T &, std::string_view>::value>> {
+  using type = std::string_view;
+  static type make(const T &value) { return std::string_view(value); }
+};
+
+template <>
+struct lazy_piece<const char *> {
+  using type = std::string_view;
+  static type make(const char *value) {
+    return value != nullptr ? std::string_view(value)
+                            : std::string_view("(null)");
+  }
+};
+
+template <>
+struct lazy_piece<char *> : lazy_piece<const char *> {};
+
+template <typename T>
+struct lazy_piece<T, std::enable_if_t<std::is_arithmetic<T>::value>> {
+  using type = formatted_piece<std::is_floating_point<T>::value ? MAX_FLOAT_SIZE
+                                                                : MAX_INT_SIZE>;
+  static type make(T value) { return type(value); }
+};
+
+template <typename T>
+using lazy_piece_t = lazy_piece<std::decay_t<T>>;
+}  // namespace detail
+
+template <typename... Pieces>
 class lazy_string_concat_helper;
 
-template <typename last_str, typename... str>
-class lazy_string_concat_helper<last_str, str...> {
+/// @name     lazy_string_concat_helper
+/// @brief    a + b + c 拼接时只记下每一段(字符串记 string_view, 数字先格式化),
+///           总长度随拼接累加; 最后按准确的长度一次写出, 只分配一次
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 20:31:05
+/// @warning  每个节点引用前一个节点和字符串参数, 这些临时对象在完整表达式
+///           结束时销毁, 只能在同一个表达式里拼接并转换. 删除拷贝构造并不能
+///           防止保存: C++17 保证复制消除, auto s = lazy + std::string("a") + "b";
+///           仍能编译, 之后再使用 s 就是悬空引用
+template <typename last_piece, typename... pieces>
+class lazy_string_concat_helper<last_piece, pieces...> {
  public:
-  lazy_string_concat_helper(last_str data,
-                            lazy_string_concat_helper<str...> tail)
-      : data_(data), tail_(tail) {}
-  last_str data_;
-  lazy_string_concat_helper<str...> tail_;
-  int size() const { return static_cast<int>(data_.size() + tail_.size()); }
-
-  template <typename It>
-  void save(It end) const {
-    const auto begin = end - data_.size();
-    std::copy(data_.cbegin(), data_.cend(), begin);
+  lazy_string_concat_helper(last_piece data,
+                            const lazy_string_concat_helper<pieces...> &tail)
+      : data_(data), tail_(tail), size_(tail.size() + data_.size()) {}
+
+  /// 只是避免意外复制整条链, 见上面的 @warning
+  lazy_string_concat_helper(const lazy_string_concat_helper &) = delete;
+  lazy_string_concat_helper &operator=(const lazy_string_concat_helper &) =
+      delete;
+
+  std::size_t size() const { return size_; }
+
+  /// 从 end 往前写入全部内容, end 之前至少要有 size() 个字节
+  void save(char *end) const {
+    char *begin = end - data_.size();
+    std::memcpy(begin, data_.data(), data_.size());
     tail_.save(begin);
   }
 
   operator std::string() const {
-    std::string result(size(), '\0');
-    save(result.end());
+    std::string result(size_, '\0');
+    save(&result[0] + size_);
     return result;
   }
 
-  lazy_string_concat_helper<std::string, last_str, str...> operator+(
-      const std::string &other) const {
-    return lazy_string_concat_helper<std::string, last_str, str...>(other,
-                                                                    *this);
-  }
+ private:
+  last_piece data_;
+  const lazy_string_concat_helper<pieces...> &tail_;
+  std::size_t size_;
 };
 
 /// 特化一个中止条件对象
@@ -58,15 +127,76 @@ template <>
 class lazy_string_concat_helper<> {
  public:
   lazy_string_concat_helper() {}
-  int size() const { return 0; }
-  template <typename It>
-  void save(It) const {}
+  std::size_t size() const { return 0; }
+  void save(char *) const {}
+  operator std::string() const { return std::string(); }
+};
+
+template <typename... pieces, typename T,
+          typename piece = typename detail::lazy_piece_t<T>::type>
+lazy_string_concat_helper<piece, pieces...> operator+(
+    const lazy_string_concat_helper<pieces...> &lhs, const T &rhs) {
+  return lazy_string_concat_helper<piece, pieces...>(
+      detail::lazy_piece_t<T>::make(rhs), lhs);
+}
+
+/// @name     lazy_string_pieces
+/// @brief    lazy_concat(a, b, c) 的结果: 按值保存每一段(字符串记 string_view,
+///           数字先格式化), 与 lazy_string_concat_helper 一样按准确长度一次写出
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 03:10:26
+/// @warning  string_view 引用调用处的参数, 只能在同一个表达式里使用
+template <typename... pieces>
+class lazy_string_pieces {
+ public:
+  explicit lazy_string_pieces(pieces... data)
+      : pieces_(data...), size_((std::size_t{0} + ... + data.size())) {}
 
-  lazy_string_concat_helper<std::string> operator+(
-      const std::string &other) const {
-    return lazy_string_concat_helper<std::string>(other, *this);
+  std::size_t size() const { return size_; }
+
+  /// 从 end 往前写入全部内容, end 之前至少要有 size() 个字节
+  void save(char *end) const {
+    char *begin = end - size_;
+    std::apply(
+        [&begin](const auto &... piece) {
+          ((std::memcpy(begin, piece.data(), piece.size()),
+            begin += piece.size()),
+           ...);
+        },
+        pieces_);
+  }
+
+  operator std::string() const {
+    std::string result(size_, '\0');
+    save(&result[0] + size_);
+    return result;
   }
+
+ private:
+  std::tuple<pieces...> pieces_;
+  std::size_t size_;
 };
+
+/// 惰性拼接的起点. 需要逐段不复制地拼接时从这里开始,
+/// 如 LOG_INFO(lee::lazy_concat() + name + " took " + 42)
+inline lazy_string_concat_helper<> lazy_concat() { return {}; }
+
+/// 已经是惰性拼接的结果时原样使用
+template <typename... pieces>
+const lazy_string_concat_helper<pieces...> &lazy_concat(
+    const lazy_string_concat_helper<pieces...> &value) {
+  return value;
+}
+
+/// 把每个参数作为一段拼接, 如 lazy_concat(name, " took ", 42);
+/// LOG_* 宏的多个参数就交给这里, LOG_INFO(name, " took ", 42) 不产生中间字符串
+template <typename... Args>
+lazy_string_pieces<typename detail::lazy_piece_t<Args>::type...> lazy_concat(
+    const Args &... args) {
+  return lazy_string_pieces<typename detail::lazy_piece_t<Args>::type...>(
+      detail::lazy_piece_t<Args>::make(args)...);
+}
 }  // namespace string
 }  // namespace lee
 
@@ -14,16 +14,50 @@
 #ifndef INCLUDE_MY_LOG_LOG_HPP_
 #define INCLUDE_MY_LOG_LOG_HPP_
 
+#include <array>
 #include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
 #include <mutex>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "my_log/file_helper.hpp"
+#include "my_log/mutex.hpp"
+#include "my_log/os.hpp"
 #include "my_log/rang.hpp"
+#include "my_log/tsc_clock.hpp"
+
+/// 编译期日志等级, 数值与 lee::level_enum 一致
+#define LEE_LOG_LEVEL_TRACE 0
+#define LEE_LOG_LEVEL_DEBUG 1
+#define LEE_LOG_LEVEL_INFO 2
+#define LEE_LOG_LEVEL_WARN 3
+#define LEE_LOG_LEVEL_ERROR 4
+#define LEE_LOG_LEVEL_CRITICAL 5
+#define LEE_LOG_LEVEL_OFF 6
+
+/// 低于此等级的日志宏在编译期被整个去掉, 参数不会被求值, 也不会留在目标文件中.
+/// 需在包含日志头文件之前定义, 例如 -DLEE_LOG_ACTIVE_LEVEL=LEE_LOG_LEVEL_INFO
+#ifndef LEE_LOG_ACTIVE_LEVEL
+#define LEE_LOG_ACTIVE_LEVEL LEE_LOG_LEVEL_TRACE
+#endif
 
 namespace lee {
 inline namespace log {
+/// 双缓冲模式下默认的缓冲区大小
+constexpr std::size_t DEFAULT_DOUBLE_BUFFER_SIZE = 1024 * 1024 * 4;
+/// 双缓冲模式下缓冲区未写满时最长多久交换一次
+constexpr std::chrono::milliseconds DEFAULT_DOUBLE_BUFFER_TIMEOUT{1000};
+
 enum class level_enum {
   trace = 0,
   debug = 1,
@@ -35,30 +69,342 @@ enum class level_enum {
   n_levels
 };
 
+static_assert(static_cast<int>(level_enum::trace) == LEE_LOG_LEVEL_TRACE &&
+                  static_cast<int>(level_enum::debug) == LEE_LOG_LEVEL_DEBUG &&
+                  static_cast<int>(level_enum::info) == LEE_LOG_LEVEL_INFO &&
+                  static_cast<int>(level_enum::warn) == LEE_LOG_LEVEL_WARN &&
+                  static_cast<int>(level_enum::error) == LEE_LOG_LEVEL_ERROR &&
+                  static_cast<int>(level_enum::critical) ==
+                      LEE_LOG_LEVEL_CRITICAL &&
+                  static_cast<int>(level_enum::off) == LEE_LOG_LEVEL_OFF,
+              "LEE_LOG_LEVEL_* must match level_enum");
+
+/// 该等级的日志宏是否被编译进来
+constexpr bool level_compiled_in(level_enum level) {
+  return static_cast<int>(level) >= LEE_LOG_ACTIVE_LEVEL;
+}
+
+/// @name     get_level_string
+/// @brief    日志中显示的等级字符串, 短的等级名补空格对齐
+///
+/// @param    level [in]  日志等级
+///
+/// @return   等级字符串
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 13:06:15
+/// @warning  线程安全
+inline const char *get_level_string(level_enum level) {
+  switch (level) {
+    case level_enum::trace:
+      return "[trace]";
+    case level_enum::debug:
+      return "[debug]";
+    case level_enum::info:
+      return "[info] ";
+    case level_enum::warn:
+      return "[warn] ";
+    case level_enum::error:
+      return "[error]";
+    case level_enum::critical:
+      return "[critical]";
+    default:
+      return "[unknow]";
+  }
+}
+
+/// @name     file_basename
+/// @brief    去掉路径中的文件夹部分, 可在编译期求值
+///
+/// @param    path  [in]  文件路径
+///
+/// @return   指向 path 内文件名开始处的指针
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 14:02:10
+/// @warning  线程安全
+constexpr const char *file_basename(const char *path) {
+  const char *name = path;
+  for (; *path != '\0'; ++path) {
+    if (*path == '/' || *path == '\\') {
+      name = path + 1;
+    }
+  }
+  return name;
+}
+
+/// 不带括号和补齐的等级名, 如 "info"
+inline const char *get_level_name(level_enum level) {
+  switch (level) {
+    case level_enum::trace:
+      return "trace";
+    case level_enum::debug:
+      return "debug";
+    case level_enum::info:
+      return "info";
+    case level_enum::warn:
+      return "warn";
+    case level_enum::error:
+      return "error";
+    case level_enum::critical:
+      return "critical";
+    default:
+      return "unknow";
+  }
+}
+
+/// 当前源文件的文件名(不含路径), 保证在编译期求值, 结果指向 __FILE__ 字面量内部
+#define LEE_FILE_BASENAME                                             \
+  ([]() -> const char * {                                             \
+    constexpr const char *lee_file_basename__ =                       \
+        ::lee::log::file_basename(__FILE__);                          \
+    return lee_file_basename__;                                       \
+  }())
+
+/// 取可变参数宏的第一个参数
+#define LEE_FIRST_ARG_(first, ...) first
+#define LEE_FIRST_ARG(...) LEE_FIRST_ARG_(__VA_ARGS__, 0)
+
+/// 以文件路径和行号计算调用点编号(FNV-1a), 可在编译期求值
+constexpr std::uint32_t make_site_id(const char *file, int line) {
+  std::uint32_t hash = 2166136261u;
+  for (; *file != '\0'; ++file) {
+    hash = (hash ^ static_cast<unsigned char>(*file)) * 16777619u;
+  }
+  return (hash ^ static_cast<std::uint32_t>(line)) * 16777619u;
+}
+
+/// @name     log_site
+/// @brief    一个日志调用点的静态信息, 由日志宏定义为 static constexpr 对象,
+///           日志记录只需要持有它的指针
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 14:05:33
+/// @warning  线程安全
+struct log_site {
+  level_enum level;
+  const char *file;  ///< 不含路径的文件名
+  const char *func;
+  int line;
+  std::uint32_t id;
+};
+
+/// @name     log_record
+/// @brief    一条日志的结构化信息, 由 log_wrapper 交给各个 sink,
+///           每个 sink 只渲染自己需要的部分
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 18:10:25
+/// @warning  只在 sink::log 调用期间有效, 所有指针和 payload 都不拥有内存
+struct log_record {
+  const log_site *site = nullptr;
+  log_clock::time_stamp time;
+  const thread_identity *thread = nullptr;
+  std::string_view payload;  ///< 用户写的日志内容
+
+  level_enum level() const { return site->level; }
+};
+
+/// 与早期版本相同的默认格式
+constexpr const char *DEFAULT_LOG_PATTERN =
+    "[%T] %L %v <In Function: %!, File: %s, Line: %#, %i>";
+
+/// @name     formatter
+/// @brief    按格式串把 log_record 渲染为一行文本, 行尾自动加换行
+/// @details  格式串在 set_pattern 时解析为一组步骤, 每条日志只按步骤依次
+///           追加到同一个缓冲区. 支持的标记:
+///           %T 时间(不带括号)  %l 等级名  %L 带括号并补齐的等级
+///           %v 日志内容  %s 文件名  %# 行号  %! 函数名
+///           %P 进程号  %t 线程号  %N 线程名  %i "PID: .., TID: ..[, Thread: ..]"
+///           %% 百分号; 其他 % 开头的内容原样输出
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 18:14:02
+/// @warning  线程不安全, 每个 sink 各自持有一份
+class formatter {
+ public:
+  /// 等级名在输出中的位置, 控制台据此着色
+  struct level_range {
+    std::size_t begin = 0;
+    std::size_t end = 0;
+  };
+
+  explicit formatter(std::string_view pattern = DEFAULT_LOG_PATTERN) {
+    set_pattern(pattern);
+  }
+
+  void set_pattern(std::string_view pattern) {
+    steps_.clear();
+    for (std::size_t i = 0; i < pattern.size(); ++i) {
+      if (pattern[i] != '%' || i + 1 == pattern.size()) {
+        append_literal_(pattern.substr(i, 1));
+        continue;
+      }
+      const char c = pattern[++i];
+      const flag kind = to_flag_(c);
+      if (kind == flag::literal) {
+        append_literal_(c == '%' ? pattern.substr(i, 1)
+                                 : pattern.substr(i - 1, 2));
+      } else {
+        steps_.push_back(step{kind, std::string()});
+      }
+    }
+  }
+
+  void set_time_format(time_precision precision,
+                       time_zone zone = time_zone::local) {
+    precision_ = precision;
+    zone_ = zone;
+  }
+
+  /// 把 record 追加到 out 的末尾, out 是 std::string 或 std::pmr::string
+  template <typename String>
+  level_range format(const log_record &record, String &out) const {
+    level_range range;
+    for (const auto &it : steps_) {
+      switch (it.kind) {
+        case flag::literal:
+          out.append(it.literal);
+          break;
+        case flag::time: {
+          char buf[MAX_TIMESTAMP_SIZE];
+          const auto n = format_timestamp(
+              buf, log_clock::to_time_point(record.time), precision_, zone_);
+          out.append(buf + 1, n - 2);  ///< 去掉两边的括号
+          break;
+        }
+        case flag::level_name:
+          range.begin = out.size();
+          out.append(get_level_name(record.level()));
+          range.end = out.size();
+          break;
+        case flag::level:
+          range.begin = out.size() + 1;
+          range.end = range.begin + std::strlen(get_level_name(record.level()));
+          out.append(get_level_string(record.level()));
+          break;
+        case flag::payload:
+          out.append(record.payload.data(), record.payload.size());
+          break;
+        case flag::file:
+          out.append(record.site->file);
+          break;
+        case flag::line:
+          append_int_(out, record.site->line);
+          break;
+        case flag::func:
+          out.append(record.site->func);
+          break;
+        case flag::pid:
+          append_int_(out, record.thread->process_id);
+          break;
+        case flag::tid:
+          append_int_(out, record.thread->tid);
+          break;
+        case flag::thread_name:
+          out.append(record.thread->name);
+          break;
+        case flag::thread:
+          out.append(record.thread->rendered);
+          break;
+      }
+    }
+    out.append("\n");
+    return range;
+  }
+
+ private:
+  enum class flag {
+    literal,
+    time,
+    level_name,
+    level,
+    payload,
+    file,
+    line,
+    func,
+    pid,
+    tid,
+    thread_name,
+    thread
+  };
+
+  struct step {
+    flag kind;
+    std::string literal;
+  };
+
+  static flag to_flag_(char c) {
+    switch (c) {
+      case 'T':
+        return flag::time;
+      case 'l':
+        return flag::level_name;
+      case 'L':
+        return flag::level;
+      case 'v':
+        return flag::payload;
+      case 's':
+        return flag::file;
+      case '#':
+        return flag::line;
+      case '!':
+        return flag::func;
+      case 'P':
+        return flag::pid;
+      case 't':
+        return flag::tid;
+      case 'N':
+        return flag::thread_name;
+      case 'i':
+        return flag::thread;
+      default:
+        return flag::literal;
+    }
+  }
+
+  /// 相邻的字面量合并成一步
+  void append_literal_(std::string_view text) {
+    if (steps_.empty() || steps_.back().kind != flag::literal) {
+      steps_.push_back(step{flag::literal, std::string()});
+    }
+    steps_.back().literal.append(text.data(), text.size());
+  }
+
+  template <typename String, typename T>
+  static void append_int_(String &out, T value) {
+    char buf[24];
+    out.append(buf, static_cast<std::size_t>(
+                        std::to_chars(buf, buf + sizeof(buf), value).ptr - buf));
+  }
+
+  std::vector<step> steps_;
+  time_precision precision_ = time_precision::milliseconds;
+  time_zone zone_ = time_zone::local;
+};
+
 class sink {
  public:
   virtual ~sink() = default;
-  virtual void log(const std::string &msg) = 0;
+  virtual void log(const log_record &record) = 0;
   virtual void flush() = 0;
 
+  /// 等级可由其他线程随时修改, 读写都用 relaxed 原子操作, 热路径上与普通读取一样快
   inline bool should_log(level_enum msg_level) const {
-    /// return msg_level >= level_.load(std::memory_order_relaxed);
-    return static_cast<int>(msg_level) >= static_cast<int>(level_);
+    return static_cast<int>(msg_level) >= level_.load(std::memory_order_relaxed);
   }
 
   inline void set_level(level_enum log_level) {
-    /// level_.store(log_level, std::memory_order_relaxed);
-    level_ = log_level;
+    level_.store(static_cast<int>(log_level), std::memory_order_relaxed);
   }
 
   inline level_enum level() const {
-    /// return static_cast<level_enum>(level_.load(std::memory_order_relaxed));
-    return level_;
+    return static_cast<level_enum>(level_.load(std::memory_order_relaxed));
   }
 
  protected:
   // sink log level - default is all
-  level_enum level_{level_enum::trace};
+  std::atomic<int> level_{static_cast<int>(level_enum::trace)};
 };
 
 template <typename Mutex>
@@ -73,54 +419,138 @@ class base_sink : public sink {
   base_sink &operator=(const base_sink &) = delete;
   base_sink &operator=(base_sink &&) = delete;
 
-  void log(const std::string &msg) final {
+  void log(const log_record &record) final {
     std::lock_guard<Mutex> lock(mutex_);
-    sink_it_(msg);
+    sink_it_(record);
   }
   void flush() final {
     std::lock_guard<Mutex> lock(mutex_);
     flush_();
   }
 
+  /// 调用者知道 *this 的具体类型为 Sink 时使用: 用限定名调用 Sink::sink_it_,
+  /// 不经过虚表, 可以内联. 参见 static_logger
+  template <typename Sink>
+  void log_as(const log_record &record) {
+    static_assert(std::is_base_of<base_sink, Sink>::value,
+                  "Sink must derive from this base_sink");
+    std::lock_guard<Mutex> lock(mutex_);
+    static_cast<Sink &>(*this).Sink::sink_it_(record);
+  }
+
+  template <typename Sink>
+  void flush_as() {
+    static_assert(std::is_base_of<base_sink, Sink>::value,
+                  "Sink must derive from this base_sink");
+    std::lock_guard<Mutex> lock(mutex_);
+    static_cast<Sink &>(*this).Sink::flush_();
+  }
+
+  void set_formatter(const formatter &f) {
+    std::lock_guard<Mutex> lock(mutex_);
+    formatter_ = f;
+  }
+
+  void set_time_format(time_precision precision,
+                       time_zone zone = time_zone::local) {
+    std::lock_guard<Mutex> lock(mutex_);
+    formatter_.set_time_format(precision, zone);
+  }
+
+  /// 参见 formatter
+  void set_pattern(std::string_view pattern) {
+    std::lock_guard<Mutex> lock(mutex_);
+    formatter_.set_pattern(pattern);
+  }
+
+  /// 格式化缓冲区改用 resource 分配, resource 须比 sink 活得久;
+  /// sink 由多个线程共用, 不要传入某个线程自己的内存池
+  void set_memory_resource(std::pmr::memory_resource *resource) {
+    std::lock_guard<Mutex> lock(mutex_);
+    std::pmr::string(resource).swap(formatted_);
+  }
+
  protected:
   Mutex mutex_;
-  virtual void sink_it_(const std::string &msg) = 0;
+  formatter formatter_;
+  std::pmr::string formatted_;  ///< 需要文本的 sink 复用的格式化缓冲区, 受 mutex_ 保护
+  virtual void sink_it_(const log_record &record) = 0;
   virtual void flush_() = 0;
 };
 
 template <typename Mutex>
 class stdout_sink final : public base_sink<Mutex> {
  public:
-  void sink_it_(const std::string &msg) override {
-    auto begin_pos = msg.find_first_of("[", msg.find_first_of("[") + 1);
-    auto end_pos = msg.find_first_of("]", msg.find_first_of("]") + 1);
-    auto level_str = msg.substr(begin_pos + 1, end_pos - begin_pos - 1);
-    std::cout << msg.substr(0, begin_pos + 1) << rang::style::bold
-              << get_cout_color(level_str) << level_str << rang::fg::reset
-              << rang::style::reset << msg.substr(end_pos);
+  void sink_it_(const log_record &record) override {
+    auto &out = base_sink<Mutex>::formatted_;
+    out.clear();
+    const auto range = base_sink<Mutex>::formatter_.format(record, out);
+    std::cout.write(out.data(), static_cast<std::streamsize>(range.begin));
+    std::cout << rang::style::bold << get_cout_color(record.level());
+    std::cout.write(out.data() + range.begin,
+                    static_cast<std::streamsize>(range.end - range.begin));
+    std::cout << rang::fg::reset << rang::style::reset;
+    std::cout.write(out.data() + range.end,
+                    static_cast<std::streamsize>(out.size() - range.end));
   }
 
   void flush_() override {}
 
  private:
-  rang::fg get_cout_color(const std::string &color_str) {
-    if (color_str == "trace") {
-      return rang::fg::gray;
-    } else if (color_str == "debug") {
-      return rang::fg::cyan;
-    } else if (color_str == "info") {
-      return rang::fg::green;
-    } else if (color_str == "warn") {
-      return rang::fg::yellow;
-    } else if (color_str == "error") {
-      return rang::fg::red;
-    } else if (color_str == "critical") {
-      return rang::fg::red;
-    } else {
-      return rang::fg::reset;
+  rang::fg get_cout_color(level_enum level) {
+    switch (level) {
+      case level_enum::trace:
+        return rang::fg::gray;
+      case level_enum::debug:
+        return rang::fg::cyan;
+      case level_enum::info:
+        return rang::fg::green;
+      case level_enum::warn:
+        return rang::fg::yellow;
+      case level_enum::error:
+      case level_enum::critical:
+        return rang::fg::red;
+      default:
+        return rang::fg::reset;
+    }
+  }
+};
+
+/// @name     counting_sink
+/// @brief    只按等级统计条数, 不做任何格式化
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 18:22:47
+/// @warning  线程安全
+template <typename Mutex>
+class counting_sink final : public base_sink<Mutex> {
+ public:
+  std::size_t count(level_enum level) {
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    return counts_[static_cast<std::size_t>(level)];
+  }
+
+  std::size_t total() {
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    std::size_t sum = 0;
+    for (auto it : counts_) {
+      sum += it;
     }
+    return sum;
   }
+
+ protected:
+  void sink_it_(const log_record &record) override {
+    ++counts_[static_cast<std::size_t>(record.level())];
+  }
+  void flush_() override {}
+
+ private:
+  friend class base_sink<Mutex>;
+  std::array<std::size_t, static_cast<std::size_t>(level_enum::n_levels)>
+      counts_{};
 };
+
 template <typename Mutex>
 class rotating_file_sink final : public base_sink<Mutex> {
  public:
@@ -138,6 +568,75 @@ class rotating_file_sink final : public base_sink<Mutex> {
     }
   }
 
+  ~rotating_file_sink() override { disable_double_buffer(); }
+
+  /// @name     enable_double_buffer
+  /// @brief    开启双缓冲模式
+  /// @details  生产者只在锁内把日志追加到前台缓冲区; 后台写线程在前台缓冲区
+  ///           写满或超过 swap_timeout 时交换前后台缓冲区, 再在锁外把后台
+  ///           缓冲区一次性写入文件. 文件滚动以整个缓冲区为单位判断.
+  ///           前台缓冲区放不下一条日志时生产者等待写线程交换, 内存用量不超过
+  ///           两个缓冲区, 追加时也不会重新分配. 单条日志超过 buffer_size 时
+  ///           等前台缓冲区为空后单独放入.
+  ///           此模式下 flush() 只唤醒写线程, 不等待数据落盘.
+  ///
+  /// @param    buffer_size   [in]  缓冲区大小(字节)
+  /// @param    swap_timeout  [in]  缓冲区未写满时最长多久交换一次
+  ///
+  /// @return   NONE
+  ///
+  /// @author   Lijiancong, pipinstall@163.com
+  /// @date     2026-10-17 11:05:37
+  /// @warning  线程安全; 写线程和生产者共用 Mutex, 不能与 null_mutex 一起使用
+  void enable_double_buffer(
+      std::size_t buffer_size = DEFAULT_DOUBLE_BUFFER_SIZE,
+      std::chrono::milliseconds swap_timeout = DEFAULT_DOUBLE_BUFFER_TIMEOUT) {
+    static_assert(!std::is_same<Mutex, null_mutex>::value,
+                  "double buffer starts a writer thread, null_mutex cannot "
+                  "guard the buffers");
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    if (double_buffer_) {
+      return;
+    }
+    double_buffer_ = true;
+    stop_writer_ = false;
+    buffer_size_ = buffer_size;
+    swap_timeout_ = swap_timeout;
+    front_.reserve(buffer_size_);
+    back_.reserve(buffer_size_);
+    writer_ = std::thread([this] { writer_loop_(); });
+  }
+
+  /// @name     disable_double_buffer
+  /// @brief    写完缓冲区中的日志, 停止写线程, 回到逐条写入的模式
+  ///
+  /// @return   NONE
+  ///
+  /// @author   Lijiancong, pipinstall@163.com
+  /// @date     2026-10-17 11:07:12
+  /// @warning  线程安全
+  void disable_double_buffer() {
+    {
+      std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+      if (!writer_.joinable()) {
+        return;
+      }
+      stop_writer_ = true;
+    }
+    swap_cv_.notify_one();
+    writer_.join();
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    /// 写线程最后一次交换之后进来的日志
+    if (!front_.empty()) {
+      front_.swap(back_);
+      rotate_for_back_buffer_();
+      write_back_buffer_();
+      back_.clear();
+    }
+    double_buffer_ = false;
+    file_helper_.flush();
+  }
+
   static inline std::string calc_filename(const std::string &filename,
                                           std::size_t index) {
     if (index == 0u) {
@@ -153,20 +652,110 @@ class rotating_file_sink final : public base_sink<Mutex> {
     return file_helper_.filename();
   }
 
+  using base_sink<Mutex>::log;
+
+  /// 直接写入一段已经排好版的文本, 不经过 formatter
+  void log(std::string_view text) {
+    std::lock_guard<Mutex> lock(base_sink<Mutex>::mutex_);
+    write_text_(text);
+  }
+
  protected:
-  void sink_it_(const std::string &msg) override {
-    /// std::string formatted;
-    /// base_sink<Mutex>::formatter_->format(msg, formatted);
-    current_size_ += msg.size();
+  friend class base_sink<Mutex>;
+  void sink_it_(const log_record &record) override {
+    auto &out = base_sink<Mutex>::formatted_;
+    out.clear();
+    base_sink<Mutex>::formatter_.format(record, out);
+    write_text_(out);
+  }
+  void flush_() override {
+    if (double_buffer_) {
+      /// 写线程醒来之前的多次 flush 只唤醒一次
+      if (!flush_requested_) {
+        flush_requested_ = true;
+        swap_cv_.notify_one();
+      }
+      return;
+    }
+    file_helper_.flush();
+  }
+
+ private:
+  void writer_loop_() {
+    for (;;) {
+      bool stop = false;
+      {
+        std::unique_lock<Mutex> lock(base_sink<Mutex>::mutex_);
+        swap_cv_.wait_for(lock, swap_timeout_, [this] {
+          return stop_writer_ || flush_requested_ || waiting_for_space_ > 0 ||
+                 front_.size() >= buffer_size_;
+        });
+        front_.swap(back_);
+        flush_requested_ = false;
+        stop = stop_writer_;
+        space_cv_.notify_all();
+        try {
+          rotate_for_back_buffer_();
+        } catch (...) {
+          /// 写线程没有调用者可以接收异常, rotate_ 失败时已截断了当前文件
+        }
+      }
+      if (!back_.empty()) {
+        try {
+          write_back_buffer_();
+        } catch (...) {
+          /// 同上, 丢弃这一缓冲区继续运行
+        }
+        back_.clear();
+      }
+      if (stop) {
+        return;
+      }
+    }
+  }
+
+  /// 需持有 mutex_
+  void write_text_(std::string_view text) {
+    if (double_buffer_) {
+      if (!front_.empty() && front_.size() + text.size() > buffer_size_) {
+        /// 写线程落后时在这里等交换, 而不是让前台缓冲区无限增长;
+        /// 等待期间释放 mutex_, 醒来时已重新持有
+        ++waiting_for_space_;
+        swap_cv_.notify_one();
+        space_cv_.wait(base_sink<Mutex>::mutex_, [this, &text] {
+          return stop_writer_ || front_.empty() ||
+                 front_.size() + text.size() <= buffer_size_;
+        });
+        --waiting_for_space_;
+      }
+      front_.append(text.data(), text.size());
+      if (front_.size() >= buffer_size_) {
+        swap_cv_.notify_one();
+      }
+      return;
+    }
+    current_size_ += text.size();
     if (current_size_ > max_size_) {
       rotate_();
-      current_size_ = msg.size();
+      current_size_ = text.size();
     }
-    file_helper_.write(msg);
+    file_helper_.write(text.data(), text.size());
+  }
+
+  /// 需持有 mutex_; 整个缓冲区写不下时先滚动文件, 保证一个缓冲区不跨两个文件
+  void rotate_for_back_buffer_() {
+    if (current_size_ > 0 && current_size_ + back_.size() > max_size_) {
+      rotate_();
+      current_size_ = 0;
+    }
+  }
+
+  void write_back_buffer_() {
+    file_helper_.write(back_);
+    file_helper_.flush();
+    current_size_ += back_.size();
   }
-  void flush_() override { file_helper_.flush(); }
 
- private:
   // Rotate files:
   // log.txt -> log.1.txt
   // log.1.txt -> log.2.txt
@@ -215,6 +804,19 @@ class rotating_file_sink final : public base_sink<Mutex> {
   std::size_t max_files_;
   std::size_t current_size_;
   file_helper file_helper_;  /// 用于打开、写文件的对象
+
+  /// 双缓冲模式用到的成员, 除 back_ 只由写线程访问外都受 mutex_ 保护
+  bool double_buffer_ = false;
+  bool stop_writer_ = false;
+  bool flush_requested_ = false;
+  int waiting_for_space_ = 0;  ///< 等待前台缓冲区空间的生产者数, 写线程见到后立即交换
+  std::size_t buffer_size_ = DEFAULT_DOUBLE_BUFFER_SIZE;
+  std::chrono::milliseconds swap_timeout_ = DEFAULT_DOUBLE_BUFFER_TIMEOUT;
+  std::string front_;
+  std::string back_;
+  std::condition_variable_any swap_cv_;
+  std::condition_variable_any space_cv_;  ///< 写线程交换后唤醒等待空间的生产者
+  std::thread writer_;
 };
 }  // namespace log
 }  // namespace lee
@@ -0,0 +1,263 @@
+///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
+/// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
+///
+/// Use of this source code is governed by a MIT license
+/// that can be found in the License file.
+///
+/// @file   memory_pool.hpp
+/// @brief  日志格式化用的 std::pmr 内存: 每个线程一个定长块内存池
+///
+/// @author lijiancong, pipinstall@163.com
+/// @date   2026-10-17 21:05:47
+///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
+
+#ifndef INCLUDE_MY_LOG_MEMORY_POOL_HPP_
+#define INCLUDE_MY_LOG_MEMORY_POOL_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <thread>
+
+namespace lee {
+inline namespace log {
+/// 内存池每一档块的大小, 更大的申请直接交给上游
+constexpr std::size_t POOL_BLOCK_SIZES[] = {64, 256, 1024, 4096};
+/// 每一档的块数, 该档第一次使用时一次性向上游申请
+constexpr std::size_t DEFAULT_POOL_BLOCKS_PER_CLASS = 16;
+
+/// 内存池的统计, 用来确定块数是否够用
+struct pool_stats {
+  std::size_t allocations = 0;  ///< 由池中的块满足的申请次数
+  std::size_t spills = 0;       ///< 没有合适的空闲块而交给上游的次数
+  std::size_t in_use = 0;       ///< 正在使用的块的总字节数
+  std::size_t high_water = 0;   ///< in_use 的最大值
+};
+
+/// @name     thread_pool_resource
+/// @brief    每个线程一个的定长块内存池. 本线程的申请和释放只操作普通的
+///           空闲链表; 其他线程释放的块用 CAS 挂到每一档的 remote 链表上,
+///           本线程空闲链表用完时一次取回. 超过最大档、对齐要求过高、该档
+///           已用完或者由其他线程申请时都交给上游, 记为一次 spill.
+/// @details  线程退出时如果还有块没有释放, 内存池会留到最后一个块释放时
+///           才析构, 因此移动到其他线程的缓冲区仍可以安全释放.
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 21:09:20
+/// @warning  stats() 只应由所属线程调用
+class thread_pool_resource final : public std::pmr::memory_resource {
+ public:
+  /// 调用线程自己的内存池, 第一次调用时创建
+  static thread_pool_resource &this_thread() {
+    thread_local owner_holder holder;
+    return *holder.pool;
+  }
+
+  pool_stats stats() const {
+    pool_stats result;
+    result.allocations = allocations_;
+    result.spills = spills_;
+    result.in_use = in_use_.load(std::memory_order_relaxed);
+    result.high_water = high_water_;
+    return result;
+  }
+
+  thread_pool_resource(const thread_pool_resource &) = delete;
+  thread_pool_resource &operator=(const thread_pool_resource &) = delete;
+
+ private:
+  static constexpr std::size_t CLASS_COUNT =
+      sizeof(POOL_BLOCK_SIZES) / sizeof(POOL_BLOCK_SIZES[0]);
+
+  struct free_block {
+    free_block *next;
+  };
+
+  struct size_class {
+    /// 该档的整块内存; 先写 end 再 release 写 begin, 其他线程释放时据此判断
+    std::atomic<char *> begin{nullptr};
+    char *end = nullptr;
+    free_block *local = nullptr;  ///< 只由所属线程访问
+    std::atomic<free_block *> remote{nullptr};
+  };
+
+  /// 线程退出时放弃所有权, 没有未释放的块才析构
+  struct owner_holder {
+    owner_holder() : pool(new thread_pool_resource()) {}
+    ~owner_holder() {
+      pool->owner_exited_.store(true, std::memory_order_release);
+      pool->release_ref_();
+    }
+    thread_pool_resource *pool;
+  };
+
+  explicit thread_pool_resource(
+      std::pmr::memory_resource *upstream = std::pmr::new_delete_resource(),
+      std::size_t blocks_per_class = DEFAULT_POOL_BLOCKS_PER_CLASS)
+      : upstream_(upstream),
+        blocks_per_class_(blocks_per_class),
+        owner_(std::this_thread::get_id()) {}
+
+  ~thread_pool_resource() override {
+    for (std::size_t i = 0; i < CLASS_COUNT; ++i) {
+      if (char *begin = classes_[i].begin.load(std::memory_order_relaxed)) {
+        upstream_->deallocate(begin,
+                              POOL_BLOCK_SIZES[i] * blocks_per_class_,
+                              alignof(std::max_align_t));
+      }
+    }
+  }
+
+  static std::size_t class_of_(std::size_t bytes, std::size_t alignment) {
+    if (alignment > alignof(std::max_align_t)) {
+      return CLASS_COUNT;
+    }
+    std::size_t i = 0;
+    while (i < CLASS_COUNT && POOL_BLOCK_SIZES[i] < bytes) {
+      ++i;
+    }
+    return i;
+  }
+
+  bool owned_by_this_thread_() const {
+    return !owner_exited_.load(std::memory_order_acquire) &&
+           owner_ == std::this_thread::get_id();
+  }
+
+  void *take_block_(std::size_t index) {
+    auto &cls = classes_[index];
+    if (cls.local == nullptr) {
+      cls.local = cls.remote.exchange(nullptr, std::memory_order_acquire);
+    }
+    if (cls.local == nullptr &&
+        cls.begin.load(std::memory_order_relaxed) == nullptr) {
+      const auto block_size = POOL_BLOCK_SIZES[index];
+      char *begin = static_cast<char *>(upstream_->allocate(
+          block_size * blocks_per_class_, alignof(std::max_align_t)));
+      cls.end = begin + block_size * blocks_per_class_;
+      for (char *p = cls.end; p != begin;) {
+        p -= block_size;
+        cls.local = new (p) free_block{cls.local};
+      }
+      cls.begin.store(begin, std::memory_order_release);
+    }
+    free_block *block = cls.local;
+    if (block != nullptr) {
+      cls.local = block->next;
+    }
+    return block;
+  }
+
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+    const auto index = class_of_(bytes, alignment);
+    void *p = nullptr;
+    const bool owner = owned_by_this_thread_();
+    if (index != CLASS_COUNT && owner) {
+      p = take_block_(index);
+    }
+    if (p == nullptr) {
+      p = upstream_->allocate(bytes, alignment);
+      if (owner) {
+        ++spills_;
+      }
+    } else {
+      ++allocations_;
+      const auto in_use =
+          in_use_.fetch_add(POOL_BLOCK_SIZES[index], std::memory_order_relaxed) +
+          POOL_BLOCK_SIZES[index];
+      if (in_use > high_water_) {
+        high_water_ = in_use;
+      }
+    }
+    refs_.fetch_add(1, std::memory_order_relaxed);
+    return p;
+  }
+
+  void do_deallocate(void *p, std::size_t bytes,
+                     std::size_t alignment) override {
+    const auto index = class_of_(bytes, alignment);
+    char *block = static_cast<char *>(p);
+    char *begin = index != CLASS_COUNT
+                      ? classes_[index].begin.load(std::memory_order_acquire)
+                      : nullptr;
+    if (begin != nullptr && block >= begin && block < classes_[index].end) {
+      auto &cls = classes_[index];
+      in_use_.fetch_sub(POOL_BLOCK_SIZES[index], std::memory_order_relaxed);
+      if (owned_by_this_thread_()) {
+        cls.local = new (p) free_block{cls.local};
+      } else {
+        auto *node = new (p) free_block{cls.remote.load(std::memory_order_relaxed)};
+        while (!cls.remote.compare_exchange_weak(node->next, node,
+                                                 std::memory_order_release,
+                                                 std::memory_order_relaxed)) {
+        }
+      }
+    } else {
+      upstream_->deallocate(p, bytes, alignment);
+    }
+    release_ref_();
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource &other) const
+      noexcept override {
+    return this == &other;
+  }
+
+  void release_ref_() {
+    if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete this;
+    }
+  }
+
+  std::pmr::memory_resource *const upstream_;
+  const std::size_t blocks_per_class_;
+  const std::thread::id owner_;
+  std::atomic<bool> owner_exited_{false};
+  /// 所属线程占一个引用, 每个未释放的块(包括交给上游的)各占一个
+  std::atomic<std::size_t> refs_{1};
+  std::atomic<std::size_t> in_use_{0};
+  std::size_t allocations_ = 0;
+  std::size_t spills_ = 0;
+  std::size_t high_water_ = 0;
+  size_class classes_[CLASS_COUNT];
+};
+
+namespace detail {
+inline std::pmr::memory_resource *&log_resource_override() {
+  thread_local std::pmr::memory_resource *resource = nullptr;
+  return resource;
+}
+}  // namespace detail
+
+/// 本线程格式化日志时使用的内存, 默认是本线程的 thread_pool_resource
+inline std::pmr::memory_resource *current_log_resource() {
+  auto *resource = detail::log_resource_override();
+  return resource != nullptr ? resource : &thread_pool_resource::this_thread();
+}
+
+/// @name     scoped_log_resource
+/// @brief    在作用域内让本线程的日志格式化使用指定的内存, 如每个请求的
+///           std::pmr::monotonic_buffer_resource; 离开作用域时恢复
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 21:16:02
+/// @warning  作用域内拼出的缓冲区不能活得比 resource 更久
+class scoped_log_resource {
+ public:
+  explicit scoped_log_resource(std::pmr::memory_resource *resource)
+      : previous_(detail::log_resource_override()) {
+    detail::log_resource_override() = resource;
+  }
+  ~scoped_log_resource() { detail::log_resource_override() = previous_; }
+
+  scoped_log_resource(const scoped_log_resource &) = delete;
+  scoped_log_resource &operator=(const scoped_log_resource &) = delete;
+
+ private:
+  std::pmr::memory_resource *previous_;
+};
+}  // namespace log
+}  // namespace lee
+
+#endif  // INCLUDE_MY_LOG_MEMORY_POOL_HPP_
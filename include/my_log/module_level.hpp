@@ -0,0 +1,227 @@
+///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
+/// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
+///
+/// Use of this source code is governed by a MIT license
+/// that can be found in the License file.
+///
+/// @file   module_level.hpp
+/// @brief  按模块层级和源文件前缀设置的日志等级, 每个调用点缓存自己的结果
+///
+/// @author lijiancong, pipinstall@163.com
+/// @date   2026-10-17 23:30:26
+///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
+
+#ifndef INCLUDE_MY_LOG_MODULE_LEVEL_HPP_
+#define INCLUDE_MY_LOG_MODULE_LEVEL_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+
+#include "my_log/log.hpp"
+
+/// 调用点所属的模块, 如 "net.tcp"; 需在包含日志头文件之前定义,
+/// 没有定义时属于根模块 "", 只受源文件前缀和根模块的规则影响
+#ifndef LEE_LOG_MODULE
+#define LEE_LOG_MODULE ""
+#endif
+
+namespace lee {
+inline namespace log {
+/// @name     module_levels
+/// @brief    模块等级规则. 模块名以 '.' 分层, "net" 的规则同样作用于
+///           "net.tcp", 除非 "net.tcp" 有自己的规则.
+/// @details  一个调用点的等级依次取: 最具体的模块规则(根模块除外)、最长的
+///           源文件名前缀规则、根模块 "" 的规则; 都没有时不限制.
+///           每次修改规则都会增加 generation, 调用点据此判断缓存是否过期,
+///           因此规则的数量不影响每次调用的开销.
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 23:36:48
+/// @warning  线程安全
+class module_levels {
+ public:
+  static module_levels &get_instance() {
+    static std::once_flag flag;
+    static module_levels *instance;
+    std::call_once(flag, [&]() { instance = new module_levels(); });
+    return *instance;
+  }
+
+  /// module 为 "" 时设置根模块, 作用于没有更具体规则的所有调用点
+  void set_level(std::string_view module, level_enum level) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    modules_.insert_or_assign(std::string(module), level);
+    invalidate();
+  }
+
+  bool clear_level(std::string_view module) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    const auto it = modules_.find(module);
+    if (it == modules_.end()) {
+      return false;
+    }
+    modules_.erase(it);
+    invalidate();
+    return true;
+  }
+
+  /// 不含路径的源文件名以 prefix 开头的调用点, 如 "net_"
+  void set_file_level(std::string_view prefix, level_enum level) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    files_.insert_or_assign(std::string(prefix), level);
+    invalidate();
+  }
+
+  bool clear_file_level(std::string_view prefix) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    const auto it = files_.find(prefix);
+    if (it == files_.end()) {
+      return false;
+    }
+    files_.erase(it);
+    invalidate();
+    return true;
+  }
+
+  void clear() {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    modules_.clear();
+    files_.clear();
+    invalidate();
+  }
+
+  /**
+   * @name     effective_level
+   * @brief    按上述顺序查找调用点的等级
+
+   * @param    module   [in]    调用点的模块
+   * @param    file     [in]    不含路径的源文件名
+
+   * @return   没有规则时为 level_enum::trace
+   * @author   Lijiancong, pipinstall@163.com
+   * @date     2026-10-17 23:41:15
+   * @warning  加读锁并查找多次, 只应在缓存过期时调用
+   */
+  level_enum effective_level(std::string_view module,
+                             std::string_view file) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    for (auto name = module; !name.empty();) {
+      const auto it = modules_.find(name);
+      if (it != modules_.end()) {
+        return it->second;
+      }
+      const auto dot = name.rfind('.');
+      name = dot == std::string_view::npos ? std::string_view()
+                                           : name.substr(0, dot);
+    }
+    if (!files_.empty()) {
+      for (auto prefix = file; !prefix.empty();
+           prefix.remove_suffix(1)) {
+        const auto it = files_.find(prefix);
+        if (it != files_.end()) {
+          return it->second;
+        }
+      }
+    }
+    const auto root = modules_.find(std::string_view());
+    return root != modules_.end() ? root->second : level_enum::trace;
+  }
+
+  /// 规则或其他参与计算的等级改变时递增
+  static std::uint64_t generation() {
+    return generation_.load(std::memory_order_relaxed);
+  }
+
+  /// 让所有调用点下次调用时重新计算等级
+  static void invalidate() {
+    generation_.fetch_add(1, std::memory_order_release);
+  }
+
+ private:
+  friend class module_site;
+
+  module_levels() = default;
+  ~module_levels() = default;
+  module_levels(const module_levels &) = delete;
+  module_levels &operator=(const module_levels &) = delete;
+
+  mutable std::shared_mutex mutex_;
+  std::map<std::string, level_enum, std::less<>> modules_;
+  std::map<std::string, level_enum, std::less<>> files_;
+  static inline std::atomic<std::uint64_t> generation_{1};
+};
+
+/// @name     module_site
+/// @brief    一个调用点缓存的等级. 等级和算出它时的 generation 放在同一个
+///           64 位原子变量里, generation 没变时只比较一次, 否则调用
+///           resolve 重新计算.
+/// @details  重新计算前先读 generation, 计算期间规则又被修改时写入的是旧的
+///           generation, 下次调用会再算一次.
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 23:47:02
+/// @warning  线程安全; 应为调用点的 static 变量, 参见 LEE_MODULE_SITE
+class module_site {
+ public:
+  constexpr module_site(std::string_view module, std::string_view file)
+      : module_(module), file_(file) {}
+
+  module_site(const module_site &) = delete;
+  module_site &operator=(const module_site &) = delete;
+
+  std::string_view module() const { return module_; }
+  std::string_view file() const { return file_; }
+
+  /// resolve(module, file) 返回该调用点的 level_enum
+  template <typename Resolve>
+  bool should_log(level_enum level, Resolve &&resolve) {
+    auto cached = cached_.load(std::memory_order_relaxed);
+    if ((cached >> LEVEL_BITS) != module_levels::generation()) {
+      cached = refresh_(resolve);
+    }
+    return static_cast<std::uint64_t>(level) >= (cached & LEVEL_MASK);
+  }
+
+  /// 只按 module_levels 的规则判断
+  bool should_log(level_enum level) {
+    return should_log(level, [](std::string_view module, std::string_view file) {
+      return module_levels::get_instance().effective_level(module, file);
+    });
+  }
+
+ private:
+  static constexpr int LEVEL_BITS = 8;
+  static constexpr std::uint64_t LEVEL_MASK = (1u << LEVEL_BITS) - 1;
+
+  template <typename Resolve>
+  std::uint64_t refresh_(Resolve &resolve) {
+    const auto generation =
+        module_levels::generation_.load(std::memory_order_acquire);
+    const auto level = static_cast<std::uint64_t>(resolve(module_, file_));
+    const auto cached = generation << LEVEL_BITS | level;
+    cached_.store(cached, std::memory_order_relaxed);
+    return cached;
+  }
+
+  const std::string_view module_;
+  const std::string_view file_;
+  std::atomic<std::uint64_t> cached_{0};  ///< generation 从 1 开始, 0 表示未计算
+};
+}  // namespace log
+}  // namespace lee
+
+/// 本调用点的 module_site, 常量初始化, 不需要 static 的线程安全检查
+#define LEE_MODULE_SITE()                                               \
+  ([]() -> ::lee::log::module_site & {                                  \
+    static ::lee::log::module_site _lee_module_site__{                  \
+        LEE_LOG_MODULE, ::lee::log::file_basename(__FILE__)};           \
+    return _lee_module_site__;                                          \
+  }())
+
+#endif  // INCLUDE_MY_LOG_MODULE_LEVEL_HPP_
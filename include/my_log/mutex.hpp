@@ -0,0 +1,158 @@
+///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
+/// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
+///
+/// Use of this source code is governed by a MIT license
+/// that can be found in the License file.
+///
+/// @file   mutex.hpp
+/// @brief  base_sink 可选的锁: 空锁、自旋锁、先自旋再挂起的自适应锁
+///
+/// @author lijiancong, pipinstall@163.com
+/// @date   2026-10-17 22:05:12
+///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
+
+#ifndef INCLUDE_MY_LOG_MUTEX_HPP_
+#define INCLUDE_MY_LOG_MUTEX_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || \
+    defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace lee {
+inline namespace log {
+/// 避免伪共享用的缓存行大小
+constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+/// 自旋等待时每次最多暂停的次数, 超过后让出 CPU
+constexpr int MAX_SPIN_BACKOFF = 64;
+/// adaptive_mutex 挂起之前自旋的轮数
+constexpr int DEFAULT_ADAPTIVE_SPIN_LIMIT = 100;
+
+/// 告诉 CPU 正在自旋, 降低功耗并让出超线程的执行资源
+inline void cpu_relax() {
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || \
+    defined(__i386__)
+  _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+  asm volatile("yield" ::: "memory");
+#endif
+}
+
+/// 只在一个线程中使用的 sink 不需要加锁; 自己启动线程的模式(如
+/// rotating_file_sink 的双缓冲)不能用它
+struct null_mutex {
+  void lock() {}
+  bool try_lock() { return true; }
+  void unlock() {}
+};
+
+/// @name     spin_mutex
+/// @brief    test-and-test-and-set 自旋锁, 等待时指数退避的 cpu_relax,
+///           退避到上限后改为 yield
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 22:08:30
+/// @warning  只适合很短的临界区; 线程数超过核数时不如 adaptive_mutex
+class spin_mutex {
+ public:
+  spin_mutex() = default;
+  spin_mutex(const spin_mutex &) = delete;
+  spin_mutex &operator=(const spin_mutex &) = delete;
+
+  void lock() {
+    int backoff = 1;
+    while (locked_.exchange(true, std::memory_order_acquire)) {
+      while (locked_.load(std::memory_order_relaxed)) {
+        if (backoff <= MAX_SPIN_BACKOFF) {
+          for (int i = 0; i < backoff; ++i) {
+            cpu_relax();
+          }
+          backoff *= 2;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    }
+  }
+
+  bool try_lock() {
+    return !locked_.load(std::memory_order_relaxed) &&
+           !locked_.exchange(true, std::memory_order_acquire);
+  }
+
+  void unlock() { locked_.store(false, std::memory_order_release); }
+
+ private:
+  std::atomic<bool> locked_{false};
+};
+
+/// @name     adaptive_mutex
+/// @brief    先自旋一段时间, 仍拿不到锁再挂起. 没有竞争时加锁解锁各是一次
+///           原子操作; 有线程挂起时解锁才去唤醒
+/// @details  state_ 为 0 未加锁, 1 加锁且没有等待者, 2 加锁且可能有等待者.
+///           等待者持有 park_mutex_ 时检查 state_ 再睡眠, 解锁者持有
+///           park_mutex_ 时唤醒, 因此不会丢失唤醒.
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 22:12:47
+/// @warning  线程安全
+class adaptive_mutex {
+ public:
+  explicit adaptive_mutex(int spin_limit = DEFAULT_ADAPTIVE_SPIN_LIMIT)
+      : spin_limit_(spin_limit) {}
+  adaptive_mutex(const adaptive_mutex &) = delete;
+  adaptive_mutex &operator=(const adaptive_mutex &) = delete;
+
+  void lock() {
+    for (int i = 0; i < spin_limit_; ++i) {
+      if (state_.load(std::memory_order_relaxed) == 0 && try_lock()) {
+        return;
+      }
+      cpu_relax();
+    }
+    if (state_.exchange(2, std::memory_order_acquire) == 0) {
+      return;
+    }
+    std::unique_lock<std::mutex> lock(park_mutex_);
+    while (state_.exchange(2, std::memory_order_acquire) != 0) {
+      park_cv_.wait(lock);
+    }
+  }
+
+  bool try_lock() {
+    int expected = 0;
+    return state_.compare_exchange_strong(expected, 1, std::memory_order_acquire,
+                                          std::memory_order_relaxed);
+  }
+
+  void unlock() {
+    if (state_.exchange(0, std::memory_order_release) == 2) {
+      std::lock_guard<std::mutex> lock(park_mutex_);
+      park_cv_.notify_one();
+    }
+  }
+
+ private:
+  std::atomic<int> state_{0};
+  const int spin_limit_;
+  std::mutex park_mutex_;
+  std::condition_variable park_cv_;
+};
+
+/// 本库自己的多线程 sink(log_wrapper 的控制台和文件输出、profiler)用的锁.
+/// 这些 sink 在锁内写控制台或文件, 持锁线程可能阻塞在系统调用里, 等待者应当
+/// 挂起而不是自旋, 所以不用 spin_mutex; adaptive_mutex 只有在多核上测得更好时
+/// 才值得替换, 目前没有多核的测量结果, 默认保持 std::mutex.
+/// 换锁前在目标机器上运行 "mutex contention benchmark", 它给出各策略相对本默认值的耗时
+using default_sink_mutex = std::mutex;
+}  // namespace log
+}  // namespace lee
+
+#endif  // INCLUDE_MY_LOG_MUTEX_HPP_
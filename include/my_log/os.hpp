@@ -24,9 +24,13 @@
 #include <cstdlib>
 #include <cstring>
 #include <ctime>
+#include <functional>
+#include <memory>
 #include <string>
 #include <thread>
 
+#include "my_log/timestamp.hpp"
+
 #ifdef _WIN32
 
 #include <io.h>       // _get_osfhandle and _isatty support
@@ -53,6 +57,7 @@
 #include <unistd.h>
 
 #ifdef __linux__
+#include <pthread.h>      // for pthread_setname_np
 #include <sys/syscall.h>  //Use gettid() syscall under linux to get thread id
 
 #elif defined(_AIX)
@@ -83,6 +88,21 @@ static const char folder_sep = '\\';
 constexpr static const char folder_sep = '/';
 #endif
 
+/// @name     get_time_string
+/// @brief    把一个时间点格式化为毫秒级别的本地时间
+///
+/// @param    time_point  [in]  时间点
+///
+/// @return   格式化后的时间
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 13:02:41
+/// @warning  线程安全
+inline std::string get_time_string(
+    const std::chrono::system_clock::time_point &time_point) {
+  return timestamp_string(time_point);
+}
+
 /// @name     get_time_string
 /// @brief    获取毫秒级别的格式化时间
 ///
@@ -92,26 +112,9 @@ constexpr static const char folder_sep = '/';
 ///
 /// @author   Lijiancong, pipinstall@163.com
 /// @date     2020-07-19 09:31:00
-/// @warning  线程不安全
+/// @warning  线程安全
 inline std::string get_time_string() {
-  auto t = std::chrono::duration_cast<std::chrono::milliseconds>(
-               std::chrono::system_clock::now().time_since_epoch())
-               .count();
-
-  tm buf;
-  auto t1 = t / 1000;
-#ifdef _WIN32
-  localtime_s(&buf, &t1);
-#else
-  localtime_r(&t1, &buf);
-#endif
-  char p[32] = {0};
-  strftime(p, sizeof(p), "[%F %T", &buf);
-  auto time_str = std::to_string(t % 1000);
-  while (time_str.size() < 3) {
-    time_str = "0" + time_str;
-  }
-  return std::string(p) + "." + time_str + "]";
+  return timestamp_string(std::chrono::system_clock::now());
 }
 
 /// @name     path_exists
@@ -330,6 +333,107 @@ inline bool fopen_s(FILE **fp, const std::string &filename,
 
   return *fp == nullptr;
 }
+
+/// @name     thread_id
+/// @brief    获取当前线程在操作系统中的线程号, 与 top -H、perf 中显示的一致
+///
+/// @param    NONE
+///
+/// @return   线程号
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 16:58:12
+/// @warning  线程安全; 每次都会进行系统调用, 打日志请用 current_thread_identity
+inline size_t thread_id() noexcept {
+#ifdef _WIN32
+  return static_cast<size_t>(::GetCurrentThreadId());
+#elif defined(__linux__)
+  return static_cast<size_t>(::syscall(SYS_gettid));
+#elif defined(_AIX) || defined(__DragonFly__) || defined(__FreeBSD__)
+  return static_cast<size_t>(::pthread_getthreadid_np());
+#elif defined(__NetBSD__)
+  return static_cast<size_t>(::_lwp_self());
+#elif defined(__sun)
+  return static_cast<size_t>(::thr_self());
+#else
+  return static_cast<size_t>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+#endif
+}
+
+/// 获取当前进程号
+inline int pid() noexcept {
+#ifdef _WIN32
+  return static_cast<int>(::GetCurrentProcessId());
+#else
+  return static_cast<int>(::getpid());
+#endif
+}
+
+/// @name     thread_identity
+/// @brief    当前线程的身份信息, 每个线程第一次使用时查询一次并渲染成字符串
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 17:02:36
+/// @warning  创建后不再修改, 可以被其他线程读取
+struct thread_identity {
+  thread_identity() : tid(thread_id()), process_id(pid()) { render(); }
+
+  /// 渲染为 "PID: 1234, TID: 1240[, Thread: io-3]"
+  void render() {
+    rendered = "PID: " + std::to_string(process_id) +
+               ", TID: " + std::to_string(tid);
+    if (!name.empty()) {
+      rendered += ", Thread: " + name;
+    }
+  }
+
+  size_t tid;
+  int process_id;
+  std::string name;      ///< set_thread_name 注册的名字
+  std::string rendered;  ///< 日志中使用的字符串
+};
+
+/// 当前线程的身份信息
+namespace detail {
+inline std::shared_ptr<const thread_identity> &thread_identity_slot() {
+  thread_local std::shared_ptr<const thread_identity> identity =
+      std::make_shared<const thread_identity>();
+  return identity;
+}
+}  // namespace detail
+
+/// 当前线程的身份信息; 异步模式下记录持有它的引用计数, 线程退出后仍然有效
+inline const std::shared_ptr<const thread_identity> &
+current_thread_identity_ptr() {
+  return detail::thread_identity_slot();
+}
+
+/// 当前线程的身份信息
+inline const thread_identity &current_thread_identity() {
+  return *current_thread_identity_ptr();
+}
+
+/// @name     set_thread_name
+/// @brief    给当前线程起一个名字, 之后该线程的日志都会带上它;
+///           Linux 下同时设置系统中的线程名(截断到15个字符)
+///
+/// @param    name  [in]  线程名, 如 "io-3"
+///
+/// @return   NONE
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 17:05:50
+/// @warning  只影响调用它的线程
+inline void set_thread_name(const std::string &name) {
+  /// 换一个新对象, 已经投递出去的记录仍然使用旧的名字
+  auto identity = std::make_shared<thread_identity>(current_thread_identity());
+  identity->name = name;
+  identity->render();
+  detail::thread_identity_slot() = std::move(identity);
+#ifdef __linux__
+  ::pthread_setname_np(::pthread_self(), name.substr(0, 15).c_str());
+#endif
+}
 }  // namespace os
 }  // namespace lee
 
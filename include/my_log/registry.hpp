@@ -0,0 +1,250 @@
+///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
+/// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
+///
+/// Use of this source code is governed by a MIT license
+/// that can be found in the License file.
+///
+/// @file   registry.hpp
+/// @brief  按名字注册的独立 logger, 各自有自己的 sink、等级和刷新策略
+///
+/// @author lijiancong, pipinstall@163.com
+/// @date   2026-10-17 23:05:40
+///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
+
+#ifndef INCLUDE_MY_LOG_REGISTRY_HPP_
+#define INCLUDE_MY_LOG_REGISTRY_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "my_log/dist_sink.hpp"
+#include "my_log/format_string.hpp"
+#include "my_log/lazy_string.hpp"
+#include "my_log/log.hpp"
+#include "my_log/os.hpp"
+#include "my_log/small_buffer.hpp"
+#include "my_log/tsc_clock.hpp"
+
+namespace lee {
+inline namespace log {
+/// @name     logger
+/// @brief    一个有名字的 logger. sink 挂在自己的 dist_sink 下, 与其他 logger
+///           不共用任何锁和文件, 各个子系统可以互不影响地写日志.
+/// @details  should_log 只读一个原子变量: 它是 logger 自己的等级和各个 sink
+///           最低等级中较高的那个, 修改等级或增删 sink 时重新计算.
+///           由 logger_registry 创建, 地址在进程内不变, 可以缓存引用.
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 23:09:12
+/// @warning  线程安全; 只有同步写入, 异步模式仍只属于 log_wrapper
+class logger {
+ public:
+  explicit logger(std::string name) : name_(std::move(name)) {
+    sinks_.set_level(level_enum::off);
+  }
+
+  logger(const logger &) = delete;
+  logger &operator=(const logger &) = delete;
+
+  const std::string &name() const { return name_; }
+
+  bool should_log(level_enum level) const {
+    return static_cast<int>(level) >= gate_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @name     write_log
+   * @brief    把日志交给本 logger 的 sink, 达到刷新等级时随后刷新
+
+   * @param    site         [in]    调用点的静态信息
+   * @param    log          [in]    日志信息
+
+   * @return   NONE
+   * @author   Lijiancong, pipinstall@163.com
+   * @date     2026-10-17 23:12:30
+   * @warning  线程安全
+   */
+  void write_log(const log_site &site, std::string_view log) {
+    log_record record;
+    record.site = &site;
+    record.time = log_clock::now();
+    record.thread = &current_thread_identity();
+    record.payload = log;
+    sinks_.log(record);
+    if (static_cast<int>(site.level) >=
+        flush_level_.load(std::memory_order_relaxed)) {
+      sinks_.flush();
+    }
+  }
+
+  /// 参见 log_wrapper::write_log
+  template <typename... Pieces>
+  void write_log(const log_site &site,
+                 const lazy_string_concat_helper<Pieces...> &log) {
+    write_lazy_log_(site, log);
+  }
+
+  template <typename... Pieces>
+  void write_log(const log_site &site,
+                 const lazy_string_pieces<Pieces...> &log) {
+    write_lazy_log_(site, log);
+  }
+
+  /// 参见 log_wrapper::write_log_fmt
+  template <typename... Args>
+  void write_log_fmt(const log_site &site, std::string_view fmt,
+                     const Args &...args) {
+    small_buffer<> buffer;
+    format_to(buffer, fmt, args...);
+    write_log(site, buffer.view());
+  }
+
+  /// 之后再修改 child 的等级需调用 refresh_sink_levels
+  void add_sink(std::shared_ptr<sink> child) {
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    sinks_.add_sink(std::move(child));
+    update_gate_();
+  }
+
+  bool remove_sink(const std::shared_ptr<sink> &child) {
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    const bool removed = sinks_.remove_sink(child);
+    update_gate_();
+    return removed;
+  }
+
+  std::vector<std::shared_ptr<sink>> sinks() const { return sinks_.sinks(); }
+
+  void refresh_sink_levels() {
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    update_gate_();
+  }
+
+  /// logger 自己的等级, 在各个 sink 的等级之前过滤
+  void set_level(level_enum level) {
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    level_.store(static_cast<int>(level), std::memory_order_relaxed);
+    update_gate_();
+  }
+
+  level_enum level() const {
+    return static_cast<level_enum>(level_.load(std::memory_order_relaxed));
+  }
+
+  /// 不低于该等级的日志写完后立即刷新, 默认从不自动刷新
+  void set_flush_level(level_enum level) {
+    flush_level_.store(static_cast<int>(level), std::memory_order_relaxed);
+  }
+
+  void flush() { sinks_.flush(); }
+
+ private:
+  template <typename lazy_string>
+  void write_lazy_log_(const log_site &site, const lazy_string &log) {
+    small_buffer<> buffer;
+    const auto size = log.size();
+    log.save(buffer.prepare(size) + size);
+    buffer.commit(size);
+    write_log(site, buffer.view());
+  }
+
+  /// 需持有 config_mutex_
+  void update_gate_() {
+    sinks_.set_level(sinks_.min_sink_level());
+    gate_.store(std::max(level_.load(std::memory_order_relaxed),
+                         static_cast<int>(sinks_.level())),
+                std::memory_order_relaxed);
+  }
+
+  const std::string name_;
+  dist_sink sinks_;
+  std::atomic<int> level_{static_cast<int>(level_enum::trace)};
+  std::atomic<int> flush_level_{static_cast<int>(level_enum::off)};
+  std::atomic<int> gate_{static_cast<int>(level_enum::off)};  ///< 没有 sink 时全部过滤
+  std::mutex config_mutex_;
+};
+
+/// @name     logger_registry
+/// @brief    进程内按名字查找 logger, 第一次查找时创建.
+/// @details  查找要加锁并比较字符串, 不适合每条日志都做; 调用点应缓存返回的
+///           引用, 或者使用 LEE_LOGGER 宏. logger 创建后不会销毁.
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 23:18:54
+/// @warning  线程安全
+class logger_registry {
+ public:
+  static logger_registry &get_instance() {
+    static std::once_flag flag;
+    static logger_registry *instance;
+    std::call_once(flag, [&]() { instance = new logger_registry(); });
+    return *instance;
+  }
+
+  /// 名为 name 的 logger, 不存在时创建一个没有 sink 的
+  logger &get(std::string_view name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = loggers_.find(name);
+    if (it == loggers_.end()) {
+      it = loggers_
+               .emplace(std::string(name),
+                        std::make_unique<logger>(std::string(name)))
+               .first;
+    }
+    return *it->second;
+  }
+
+  /// 不存在时返回 nullptr
+  logger *find(std::string_view name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = loggers_.find(name);
+    return it != loggers_.end() ? it->second.get() : nullptr;
+  }
+
+  std::vector<std::string> names() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::string> result;
+    result.reserve(loggers_.size());
+    for (const auto &it : loggers_) {
+      result.push_back(it.first);
+    }
+    return result;
+  }
+
+  void flush_all() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &it : loggers_) {
+      it.second->flush();
+    }
+  }
+
+ private:
+  logger_registry() = default;
+  ~logger_registry() = default;
+  logger_registry(const logger_registry &) = delete;
+  logger_registry &operator=(const logger_registry &) = delete;
+
+  mutable std::mutex mutex_;
+  std::map<std::string, std::unique_ptr<logger>, std::less<>> loggers_;
+};
+}  // namespace log
+}  // namespace lee
+
+/// 名为 name 的 logger 的引用, 每个调用点只在第一次执行时查找一次.
+/// name 须是常量表达式, 通常是字符串字面量
+#define LEE_LOGGER(name)                                                  \
+  ([]() -> ::lee::log::logger & {                                        \
+    static ::lee::log::logger &_lee_cached_logger__ =                    \
+        ::lee::log::logger_registry::get_instance().get(name);           \
+    return _lee_cached_logger__;                                         \
+  }())
+
+#endif  // INCLUDE_MY_LOG_REGISTRY_HPP_
@@ -0,0 +1,141 @@
+///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
+/// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
+///
+/// Use of this source code is governed by a MIT license
+/// that can be found in the License file.
+///
+/// @file   small_buffer.hpp
+/// @brief  自带栈上空间的字符缓冲区, 超出后才在堆上分配
+///
+/// @author lijiancong, pipinstall@163.com
+/// @date   2026-10-17 17:30:08
+///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
+
+#ifndef INCLUDE_MY_LOG_SMALL_BUFFER_HPP_
+#define INCLUDE_MY_LOG_SMALL_BUFFER_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+
+#include "my_log/memory_pool.hpp"
+
+namespace lee {
+inline namespace log {
+/// log_stream 内联缓冲区的默认大小
+constexpr std::size_t DEFAULT_INLINE_BUFFER_SIZE = 256;
+
+/// @name     small_buffer
+/// @brief    前 N 个字节放在对象内部, 写满后整体搬到 resource 上并按两倍增长;
+///           没有指定 resource 时在第一次搬出时取 current_log_resource()
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 17:31:44
+/// @warning  线程不安全; 只能移动不能复制
+template <std::size_t N = DEFAULT_INLINE_BUFFER_SIZE>
+class small_buffer {
+ public:
+  small_buffer() = default;
+  explicit small_buffer(std::pmr::memory_resource *resource)
+      : resource_(resource) {}
+
+  ~small_buffer() { release_(); }
+
+  small_buffer(small_buffer &&other) noexcept { move_from_(other); }
+
+  small_buffer &operator=(small_buffer &&other) noexcept {
+    if (this != &other) {
+      release_();
+      move_from_(other);
+    }
+    return *this;
+  }
+
+  small_buffer(const small_buffer &) = delete;
+  small_buffer &operator=(const small_buffer &) = delete;
+
+  const char *data() const { return heap_ != nullptr ? heap_ : inline_; }
+  char *data() { return heap_ != nullptr ? heap_ : inline_; }
+  std::size_t size() const { return size_; }
+  std::size_t capacity() const { return capacity_; }
+  bool empty() const { return size_ == 0; }
+  /// 是否已经搬出内联缓冲区
+  bool spilled() const { return heap_ != nullptr; }
+
+  void clear() { size_ = 0; }
+
+  void reserve(std::size_t capacity) {
+    if (capacity <= capacity_) {
+      return;
+    }
+    if (resource_ == nullptr) {
+      resource_ = current_log_resource();
+    }
+    char *bigger = static_cast<char *>(resource_->allocate(capacity, 1));
+    std::memcpy(bigger, data(), size_);
+    release_();
+    heap_ = bigger;
+    capacity_ = capacity;
+  }
+
+  /// 预留 n 个字节并返回写入位置, 写完后用 commit 确认实际写入的长度
+  char *prepare(std::size_t n) {
+    if (size_ + n > capacity_) {
+      reserve(std::max(capacity_ * 2, size_ + n));
+    }
+    return data() + size_;
+  }
+
+  void commit(std::size_t n) { size_ += n; }
+
+  void append(const char *str, std::size_t n) {
+    std::memcpy(prepare(n), str, n);
+    size_ += n;
+  }
+
+  void append(std::string_view str) { append(str.data(), str.size()); }
+
+  void push_back(char c) {
+    *prepare(1) = c;
+    ++size_;
+  }
+
+  std::string_view view() const { return std::string_view(data(), size_); }
+  std::string str() const { return std::string(data(), size_); }
+
+ private:
+  /// 只释放搬出去的内存, 不改变 size_ 和 capacity_
+  void release_() {
+    if (heap_ != nullptr) {
+      resource_->deallocate(heap_, capacity_, 1);
+      heap_ = nullptr;
+    }
+  }
+
+  void move_from_(small_buffer &other) {
+    size_ = other.size_;
+    capacity_ = other.capacity_;
+    resource_ = other.resource_;
+    if (other.heap_ != nullptr) {
+      heap_ = other.heap_;
+      other.heap_ = nullptr;
+    } else {
+      std::memcpy(inline_, other.inline_, size_);
+    }
+    other.size_ = 0;
+    other.capacity_ = N;
+  }
+
+  std::size_t size_ = 0;
+  std::size_t capacity_ = N;
+  char *heap_ = nullptr;
+  std::pmr::memory_resource *resource_ = nullptr;  ///< 搬出内联缓冲区时使用
+  char inline_[N];
+};
+}  // namespace log
+}  // namespace lee
+
+#endif  // INCLUDE_MY_LOG_SMALL_BUFFER_HPP_
@@ -0,0 +1,166 @@
+///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
+/// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
+///
+/// Use of this source code is governed by a MIT license
+/// that can be found in the License file.
+///
+/// @file   static_logger.hpp
+/// @brief  编译期组合的一组 sink, 分发时不经过虚函数
+///
+/// @author lijiancong, pipinstall@163.com
+/// @date   2026-10-17 21:40:18
+///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
+
+#ifndef INCLUDE_MY_LOG_STATIC_LOGGER_HPP_
+#define INCLUDE_MY_LOG_STATIC_LOGGER_HPP_
+
+#include <cstddef>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "my_log/log.hpp"
+#include "my_log/os.hpp"
+#include "my_log/tsc_clock.hpp"
+
+namespace lee {
+inline namespace log {
+namespace detail {
+template <typename Sink, typename = void>
+struct has_log_as : std::false_type {};
+template <typename Sink>
+struct has_log_as<Sink, std::void_t<decltype(std::declval<Sink &>()
+                                                 .template log_as<Sink>(
+                                                     std::declval<
+                                                         const log_record &>()))>>
+    : std::true_type {};
+
+/// 持有一个 sink, 由一个参数 tuple 原地构造; sink 不能移动
+template <typename Sink>
+struct sink_slot {
+  sink_slot() = default;
+
+  template <typename... Args>
+  explicit sink_slot(std::tuple<Args...> args)
+      : sink_slot(args, std::index_sequence_for<Args...>()) {}
+
+  template <typename Tuple, std::size_t... I>
+  sink_slot(Tuple &args, std::index_sequence<I...>)
+      : sink(std::forward<std::tuple_element_t<I, Tuple>>(std::get<I>(args))...) {
+  }
+
+  Sink sink;
+};
+
+/// 派生自 base_sink 的 sink 走 log_as, 其他类型只要有 log(const log_record&)
+template <typename Sink>
+inline void dispatch_log(Sink &sink, const log_record &record) {
+  if constexpr (has_log_as<Sink>::value) {
+    sink.template log_as<Sink>(record);
+  } else {
+    sink.log(record);
+  }
+}
+
+template <typename Sink>
+inline void dispatch_flush(Sink &sink) {
+  if constexpr (has_log_as<Sink>::value) {
+    sink.template flush_as<Sink>();
+  } else {
+    sink.flush();
+  }
+}
+}  // namespace detail
+
+/// @name     static_logger
+/// @brief    由模板参数给出的一组 sink. 每条日志对每个 sink 先判断等级,
+///           再直接调用它的 sink_it_, 不经过 sink 和 base_sink 的两次虚函数,
+///           整条流水线可以内联; 等级是常量时判断也会在编译期折叠.
+/// @details  运行时才确定 sink 的场合仍使用 sink 接口. 非 base_sink 的类型
+///           只需提供 should_log(level_enum)、log(const log_record&) 和 flush().
+///
+/// 例: static_logger<rotating_file_sink<std::mutex>, stdout_sink<std::mutex>>
+///         logger(std::make_tuple("log/app.log"), std::make_tuple());
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 21:44:50
+/// @warning  线程安全与否取决于各个 sink 的 Mutex
+template <typename... Sinks>
+class static_logger {
+ public:
+  static_logger() = default;
+
+  /// 每个 sink 一个参数 tuple, 如 std::make_tuple(path), 空 tuple 表示默认构造
+  template <typename... ArgTuples,
+            typename = std::enable_if_t<sizeof...(ArgTuples) ==
+                                            sizeof...(Sinks) &&
+                                        sizeof...(Sinks) != 0>>
+  explicit static_logger(ArgTuples &&...args)
+      : slots_(std::forward<ArgTuples>(args)...) {}
+
+  static_logger(const static_logger &) = delete;
+  static_logger &operator=(const static_logger &) = delete;
+
+  template <std::size_t I>
+  auto &sink() {
+    return std::get<I>(slots_).sink;
+  }
+
+  template <typename Sink>
+  Sink &sink() {
+    return std::get<detail::sink_slot<Sink>>(slots_).sink;
+  }
+
+  /// 是否至少有一个 sink 接收该等级
+  bool should_log(level_enum level) const {
+    return std::apply(
+        [level](const auto &...slot) {
+          return (false || ... || slot.sink.should_log(level));
+        },
+        slots_);
+  }
+
+  void log(const log_record &record) {
+    const auto level = record.level();
+    std::apply(
+        [&record, level](auto &...slot) {
+          ((slot.sink.should_log(level)
+                ? detail::dispatch_log(slot.sink, record)
+                : void()),
+           ...);
+        },
+        slots_);
+  }
+
+  /// 以调用线程和当前时刻组成 log_record 再写入
+  void log(const log_site &site, std::string_view payload) {
+    if (!should_log(site.level)) {
+      return;
+    }
+    log_record record;
+    record.site = &site;
+    record.time = log_clock::now();
+    record.thread = &current_thread_identity();
+    record.payload = payload;
+    log(record);
+  }
+
+  void flush() {
+    std::apply([](auto &...slot) { (detail::dispatch_flush(slot.sink), ...); },
+               slots_);
+  }
+
+  /// 所有 sink 都需要有 set_level
+  void set_level(level_enum level) {
+    std::apply([level](auto &...slot) { (slot.sink.set_level(level), ...); },
+               slots_);
+  }
+
+ private:
+  std::tuple<detail::sink_slot<Sinks>...> slots_;
+};
+}  // namespace log
+}  // namespace lee
+
+#endif  // INCLUDE_MY_LOG_STATIC_LOGGER_HPP_
@@ -0,0 +1,396 @@
+///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
+/// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
+///
+/// Use of this source code is governed by a MIT license
+/// that can be found in the License file.
+///
+/// @file   thread_ring.hpp
+/// @brief  每个线程独占的单生产者环形队列, 以及按时间戳归并的消费线程
+///
+/// @author lijiancong, pipinstall@163.com
+/// @date   2026-10-17 10:24:52
+///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
+
+#ifndef INCLUDE_MY_LOG_THREAD_RING_HPP_
+#define INCLUDE_MY_LOG_THREAD_RING_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "my_log/async.hpp"
+#include "my_log/mutex.hpp"
+#include "my_log/tsc_clock.hpp"
+
+namespace lee {
+inline namespace log {
+/// @name     spsc_ring
+/// @brief    单生产者单消费者的无锁环形队列, 容量取整到2的幂
+/// @details  生产者只写 tail_, 消费者只写 head_, 两者各占一个缓存行;
+///           对方的下标各自缓存一份, 只有缓存的值不够用时才去读共享的下标.
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 10:26:13
+/// @warning  只允许一个线程 try_push, 一个线程 front/pop
+template <typename T>
+class spsc_ring {
+ public:
+  explicit spsc_ring(std::size_t capacity)
+      : mask_(round_up_pow2(capacity) - 1), slots_(new T[mask_ + 1]) {}
+
+  spsc_ring(const spsc_ring &) = delete;
+  spsc_ring &operator=(const spsc_ring &) = delete;
+
+  /// 生产者调用, 队列满时返回假
+  bool try_push(T &&item) {
+    const auto tail = tail_.load(std::memory_order_relaxed);
+    if (tail - cached_head_ > mask_) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+      if (tail - cached_head_ > mask_) {
+        return false;
+      }
+    }
+    slots_[tail & mask_] = std::move(item);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// 消费者调用, 队列为空时返回空指针
+  T *front() {
+    const auto head = head_.load(std::memory_order_relaxed);
+    if (head == cached_tail_) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+      if (head == cached_tail_) {
+        return nullptr;
+      }
+    }
+    return &slots_[head & mask_];
+  }
+
+  /// 消费者调用, 必须在 front() 返回非空之后
+  void pop() {
+    const auto head = head_.load(std::memory_order_relaxed);
+    slots_[head & mask_] = T();
+    head_.store(head + 1, std::memory_order_release);
+  }
+
+  std::size_t capacity() const { return mask_ + 1; }
+
+ private:
+  static std::size_t round_up_pow2(std::size_t n) {
+    std::size_t result = 1;
+    while (result < n) {
+      result <<= 1;
+    }
+    return result;
+  }
+
+  const std::size_t mask_;
+  const std::unique_ptr<T[]> slots_;
+  alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> head_{0};
+  std::size_t cached_tail_ = 0;  ///< 消费者私有
+  alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> tail_{0};
+  std::size_t cached_head_ = 0;  ///< 生产者私有
+};
+
+/// @name     per_thread_rings
+/// @brief    每个线程第一次写入时注册一个自己的 spsc_ring, 消费者按
+///           (timestamp, sequence) 归并所有队列
+/// @details  生产者除第一次注册外不加锁, 也不写任何与其他生产者共享的
+///           缓存行. 线程退出后其队列会被标记为 retired, 消费者写完其中的
+///           记录后把它放回空闲列表, 留给之后注册的新线程复用.
+///           T 需要有 timestamp 和 sequence 两个成员.
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 10:29:05
+/// @warning  local 线程安全; refresh/drain/recycle 同一时刻只能有一个线程调用
+template <typename T>
+class per_thread_rings {
+ public:
+  struct slot {
+    explicit slot(std::size_t ring_size) : ring(ring_size) {}
+    spsc_ring<T> ring;
+    std::atomic<bool> in_use{true};
+    std::atomic<bool> retired{false};
+    std::atomic<bool> detached{false};  ///< 所属的 per_thread_rings 已析构
+    /// 以下字段只由当前所属线程写入, 与消费者读的标志分开放在另一个缓存行
+    alignas(CACHE_LINE_SIZE) std::uint64_t sequence = 0;
+    std::atomic<std::size_t> blocked{0};
+    std::atomic<std::size_t> dropped_newest{0};
+  };
+  using snapshot_t = std::vector<std::shared_ptr<slot>>;
+
+  explicit per_thread_rings(std::size_t ring_size)
+      : id_(next_id_()), ring_size_(ring_size) {}
+
+  ~per_thread_rings() {
+    std::lock_guard<std::mutex> lock(slots_mutex_);
+    for (auto &it : slots_) {
+      it->detached.store(true, std::memory_order_release);
+    }
+  }
+
+  per_thread_rings(const per_thread_rings &) = delete;
+  per_thread_rings &operator=(const per_thread_rings &) = delete;
+
+  /// 生产者调用, 返回当前线程的队列, 第一次调用时注册
+  slot &local() {
+    thread_local thread_slots local;
+    for (auto &it : local.slots) {
+      if (it.first == id_) {
+        return *it.second;
+      }
+    }
+    local.slots.erase(
+        std::remove_if(
+            local.slots.begin(), local.slots.end(),
+            [](const std::pair<std::uint64_t, std::shared_ptr<slot>> &it) {
+              return it.second->detached.load(std::memory_order_acquire);
+            }),
+        local.slots.end());
+    auto fresh = register_();
+    local.slots.emplace_back(id_, fresh);
+    return *fresh;
+  }
+
+  /// 消费者调用, 有新注册的队列时更新 snapshot
+  void refresh(snapshot_t &snapshot, std::size_t &generation) {
+    std::lock_guard<std::mutex> lock(slots_mutex_);
+    if (generation != slots_generation_) {
+      snapshot = slots_;
+      generation = slots_generation_;
+    }
+  }
+
+  /// 消费者调用, 归并到所有队列为空, 返回处理的记录条数
+  template <typename Handler>
+  static std::size_t drain(snapshot_t &snapshot, Handler &&handler) {
+    std::size_t count = 0;
+    for (;;) {
+      slot *oldest = nullptr;
+      T *oldest_item = nullptr;
+      for (auto &it : snapshot) {
+        auto *item = it->ring.front();
+        if (item == nullptr) {
+          continue;
+        }
+        if (oldest_item == nullptr || item->timestamp < oldest_item->timestamp ||
+            (item->timestamp == oldest_item->timestamp &&
+             item->sequence < oldest_item->sequence)) {
+          oldest = it.get();
+          oldest_item = item;
+        }
+      }
+      if (oldest == nullptr) {
+        return count;
+      }
+      T out = std::move(*oldest_item);
+      oldest->ring.pop();
+      handler(out);
+      ++count;
+    }
+  }
+
+  /// 消费者调用, 把已退出线程的空队列放回空闲列表
+  static void recycle(snapshot_t &snapshot) {
+    for (auto &it : snapshot) {
+      if (it->retired.load(std::memory_order_acquire) &&
+          it->ring.front() == nullptr) {
+        it->retired.store(false, std::memory_order_relaxed);
+        it->in_use.store(false, std::memory_order_release);
+      }
+    }
+  }
+
+  overflow_counters counters() {
+    overflow_counters result;
+    std::lock_guard<std::mutex> lock(slots_mutex_);
+    for (auto &it : slots_) {
+      result.blocked += it->blocked.load(std::memory_order_relaxed);
+      result.dropped_newest +=
+          it->dropped_newest.load(std::memory_order_relaxed);
+    }
+    return result;
+  }
+
+  /// 曾经注册过的队列个数(含空闲待复用的)
+  std::size_t size() {
+    std::lock_guard<std::mutex> lock(slots_mutex_);
+    return slots_.size();
+  }
+
+ private:
+  /// 线程退出时把自己持有的队列标记为 retired
+  struct thread_slots {
+    ~thread_slots() {
+      for (auto &it : slots) {
+        it.second->retired.store(true, std::memory_order_release);
+      }
+    }
+    std::vector<std::pair<std::uint64_t, std::shared_ptr<slot>>> slots;
+  };
+
+  static std::uint64_t next_id_() {
+    static std::atomic<std::uint64_t> id{0};
+    return ++id;
+  }
+
+  std::shared_ptr<slot> register_() {
+    std::lock_guard<std::mutex> lock(slots_mutex_);
+    for (auto &it : slots_) {
+      if (!it->in_use.load(std::memory_order_acquire)) {
+        it->in_use.store(true, std::memory_order_relaxed);
+        return it;
+      }
+    }
+    slots_.push_back(std::make_shared<slot>(ring_size_));
+    ++slots_generation_;
+    return slots_.back();
+  }
+
+  const std::uint64_t id_;
+  const std::size_t ring_size_;
+  std::mutex slots_mutex_;
+  snapshot_t slots_;
+  std::size_t slots_generation_ = 0;
+};
+
+/// 环形队列中的一条记录, 带上归并排序用的时间戳和线程内序号
+struct ring_msg {
+  std::int64_t timestamp = 0;
+  std::uint64_t sequence = 0;
+  async_msg msg;
+};
+
+/// @name     thread_ring_worker
+/// @brief    每个打日志的线程第一次写入时注册一个自己的 spsc_ring,
+///           后台线程按 (时间戳, 序号) 归并所有队列后交给 handler
+/// @details  队列的注册、复用和归并参见 per_thread_rings.
+///           stop() 之后 post_log 返回假; 与 stop() 同时进行的 post_log
+///           写入的记录可能不会被处理, 调用方需保证 stop() 时没有正在进行的
+///           post_log, 参见 log_wrapper::disable_async.
+///           overwrite_oldest 策略需要生产者弹出最旧的记录, 这会破坏单生产者
+///           单消费者的约定, 所以在这里按 drop_newest 处理.
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 10:31:40
+/// @warning  线程安全
+class thread_ring_worker final : public async_backend {
+ public:
+  using handler_t = async_worker::handler_t;
+
+  thread_ring_worker(std::size_t ring_size, overflow_policy policy,
+                     handler_t handler,
+                     std::chrono::microseconds idle_sleep =
+                         std::chrono::microseconds(500))
+      : rings_(ring_size),
+        policy_(policy),
+        handler_(std::move(handler)),
+        idle_sleep_(idle_sleep) {
+    thread_ = std::thread([this] { run_(); });
+  }
+
+  ~thread_ring_worker() override { stop(); }
+
+  thread_ring_worker(const thread_ring_worker &) = delete;
+  thread_ring_worker &operator=(const thread_ring_worker &) = delete;
+
+  using async_backend::post_log;
+
+  bool post_log(async_msg &&msg) override {
+    /// 停止后后台线程不会再读队列
+    if (stopping_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    auto &slot = rings_.local();
+    ring_msg m;
+    m.timestamp = static_cast<std::int64_t>(tsc_clock::get_instance().ticks());
+    m.sequence = slot.sequence++;
+    m.msg = std::move(msg);
+    if (slot.ring.try_push(std::move(m))) {
+      return true;
+    }
+    if (policy_ != overflow_policy::block) {
+      slot.dropped_newest.store(
+          slot.dropped_newest.load(std::memory_order_relaxed) + 1,
+          std::memory_order_relaxed);
+      return true;
+    }
+    slot.blocked.store(slot.blocked.load(std::memory_order_relaxed) + 1,
+                       std::memory_order_relaxed);
+    while (!slot.ring.try_push(std::move(m))) {
+      if (stopping_.load(std::memory_order_acquire)) {
+        return false;
+      }
+      std::this_thread::yield();
+    }
+    return true;
+  }
+
+  void post_flush() override {
+    flush_requested_.store(true, std::memory_order_release);
+  }
+
+  void stop() override {
+    std::lock_guard<std::mutex> lock(stop_mutex_);
+    if (!thread_.joinable()) {
+      return;
+    }
+    stopping_.store(true, std::memory_order_release);
+    thread_.join();
+  }
+
+  overflow_counters counters() override { return rings_.counters(); }
+
+  /// 曾经注册过的队列个数(含空闲待复用的)
+  std::size_t ring_count() { return rings_.size(); }
+
+ private:
+  using rings_t = per_thread_rings<ring_msg>;
+
+  void run_() {
+    rings_t::snapshot_t snapshot;
+    std::size_t generation = 0;
+    for (;;) {
+      /// 先读停止标志, 保证停止前投递的记录都在本轮被写完
+      const bool stopping = stopping_.load(std::memory_order_acquire);
+      rings_.refresh(snapshot, generation);
+      const auto count =
+          rings_t::drain(snapshot, [this](ring_msg &m) { handler_(m.msg); });
+      rings_t::recycle(snapshot);
+      if (flush_requested_.exchange(false, std::memory_order_acq_rel)) {
+        async_msg flush;
+        flush.type = async_msg_type::flush;
+        handler_(flush);
+      }
+      if (stopping) {
+        return;
+      }
+      if (count == 0) {
+        std::this_thread::sleep_for(idle_sleep_);
+      }
+    }
+  }
+
+  rings_t rings_;
+  const overflow_policy policy_;
+  handler_t handler_;
+  const std::chrono::microseconds idle_sleep_;
+
+  std::atomic<bool> flush_requested_{false};
+  std::atomic<bool> stopping_{false};
+  std::mutex stop_mutex_;
+  std::thread thread_;
+};
+}  // namespace log
+}  // namespace lee
+
+#endif  // INCLUDE_MY_LOG_THREAD_RING_HPP_
@@ -0,0 +1,200 @@
+///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
+/// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
+///
+/// Use of this source code is governed by a MIT license
+/// that can be found in the License file.
+///
+/// @file   timestamp.hpp
+/// @brief  日志时间戳的格式化, 按秒缓存日期部分, 秒以下部分查表输出
+///
+/// @author lijiancong, pipinstall@163.com
+/// @date   2026-10-17 15:40:26
+///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
+
+#ifndef INCLUDE_MY_LOG_TIMESTAMP_HPP_
+#define INCLUDE_MY_LOG_TIMESTAMP_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <string>
+
+namespace lee {
+inline namespace os {
+/// 秒以下显示几位
+enum class time_precision { milliseconds, microseconds, nanoseconds };
+
+/// 本地时间还是UTC时间
+enum class time_zone { local, utc };
+
+/// "[YYYY-MM-DD HH:MM:SS.nnnnnnnnn]" 的最大长度
+constexpr std::size_t MAX_TIMESTAMP_SIZE = 32;
+
+namespace detail {
+/// "00" 到 "99" 的两位数字表
+constexpr char DIGITS_TABLE[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+inline char *write_2digits(char *out, unsigned value) {
+  std::memcpy(out, &DIGITS_TABLE[value * 2], 2);
+  return out + 2;
+}
+
+/// 写固定宽度的十进制数, 不足补0
+inline char *write_fixed_digits(char *out, std::uint32_t value, int width) {
+  char *end = out + width;
+  char *p = end;
+  while (width >= 2) {
+    p -= 2;
+    std::memcpy(p, &DIGITS_TABLE[(value % 100) * 2], 2);
+    value /= 100;
+    width -= 2;
+  }
+  if (width == 1) {
+    *--p = static_cast<char>('0' + value % 10);
+  }
+  return end;
+}
+
+/// 自1970-01-01起的天数转换为公历年月日(UTC), 不依赖时区和C库
+inline void civil_from_days(std::int64_t days, int &year, unsigned &month,
+                            unsigned &day) {
+  days += 719468;
+  const std::int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+  const auto doe = static_cast<unsigned>(days - era * 146097);
+  const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  const unsigned mp = (5 * doy + 2) / 153;
+  day = doy - (153 * mp + 2) / 5 + 1;
+  month = mp < 10 ? mp + 3 : mp - 9;
+  year = static_cast<int>(static_cast<std::int64_t>(yoe) + era * 400 +
+                          (month <= 2 ? 1 : 0));
+}
+
+/// 每个线程每种时区缓存一份 "[YYYY-MM-DD HH:MM:SS"
+struct second_cache {
+  static constexpr std::size_t PREFIX_SIZE = 20;
+  std::int64_t second = INT64_MIN;
+  char prefix[PREFIX_SIZE];
+
+  void update(std::int64_t sec, time_zone zone) {
+    second = sec;
+    int year = 1970;
+    unsigned month = 1, day = 1, hour = 0, minute = 0, seconds = 0;
+    if (zone == time_zone::utc) {
+      auto days = sec >= 0 ? sec / 86400 : (sec - 86399) / 86400;
+      auto rest = static_cast<unsigned>(sec - days * 86400);
+      civil_from_days(days, year, month, day);
+      hour = rest / 3600;
+      minute = rest / 60 % 60;
+      seconds = rest % 60;
+    } else {
+      tm buf;
+      time_t t = static_cast<time_t>(sec);
+#ifdef _WIN32
+      localtime_s(&buf, &t);
+#else
+      localtime_r(&t, &buf);
+#endif
+      year = buf.tm_year + 1900;
+      month = static_cast<unsigned>(buf.tm_mon + 1);
+      day = static_cast<unsigned>(buf.tm_mday);
+      hour = static_cast<unsigned>(buf.tm_hour);
+      minute = static_cast<unsigned>(buf.tm_min);
+      seconds = static_cast<unsigned>(buf.tm_sec);
+    }
+    char *p = prefix;
+    *p++ = '[';
+    p = write_fixed_digits(p, static_cast<std::uint32_t>(year), 4);
+    *p++ = '-';
+    p = write_2digits(p, month);
+    *p++ = '-';
+    p = write_2digits(p, day);
+    *p++ = ' ';
+    p = write_2digits(p, hour);
+    *p++ = ':';
+    p = write_2digits(p, minute);
+    *p++ = ':';
+    write_2digits(p, seconds);
+  }
+};
+}  // namespace detail
+
+/// @name     format_timestamp
+/// @brief    把时间点格式化为 "[YYYY-MM-DD HH:MM:SS.mmm]"
+/// @details  日期和时分秒每个线程每秒只计算一次, 本地时间只有在跨秒时才调用
+///           localtime_r; UTC 模式完全不经过时区转换. 秒以下的部分查表输出.
+///
+/// @param    out         [out] 至少 MAX_TIMESTAMP_SIZE 字节的缓冲区
+/// @param    time_point  [in]  时间点
+/// @param    precision   [in]  秒以下显示毫秒、微秒还是纳秒
+/// @param    zone        [in]  本地时间或UTC
+///
+/// @return   写入的字节数
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 15:48:03
+/// @warning  线程安全
+inline std::size_t format_timestamp(
+    char *out, const std::chrono::system_clock::time_point &time_point,
+    time_precision precision = time_precision::milliseconds,
+    time_zone zone = time_zone::local) {
+  const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      time_point.time_since_epoch())
+                      .count();
+  auto sec = ns / 1000000000;
+  auto sub = ns % 1000000000;
+  if (sub < 0) {
+    sub += 1000000000;
+    --sec;
+  }
+
+  thread_local detail::second_cache caches[2];
+  auto &cache = caches[zone == time_zone::utc ? 1 : 0];
+  if (cache.second != sec) {
+    cache.update(sec, zone);
+  }
+
+  char *p = out;
+  std::memcpy(p, cache.prefix, detail::second_cache::PREFIX_SIZE);
+  p += detail::second_cache::PREFIX_SIZE;
+  *p++ = '.';
+  const auto fraction = static_cast<std::uint32_t>(sub);
+  switch (precision) {
+    case time_precision::nanoseconds:
+      p = detail::write_fixed_digits(p, fraction, 9);
+      break;
+    case time_precision::microseconds:
+      p = detail::write_fixed_digits(p, fraction / 1000, 6);
+      break;
+    default:
+      p = detail::write_fixed_digits(p, fraction / 1000000, 3);
+      break;
+  }
+  *p++ = ']';
+  return static_cast<std::size_t>(p - out);
+}
+
+/// format_timestamp 的 std::string 版本
+inline std::string timestamp_string(
+    const std::chrono::system_clock::time_point &time_point,
+    time_precision precision = time_precision::milliseconds,
+    time_zone zone = time_zone::local) {
+  char buf[MAX_TIMESTAMP_SIZE];
+  return std::string(buf,
+                     format_timestamp(buf, time_point, precision, zone));
+}
+}  // namespace os
+}  // namespace lee
+
+#endif  // INCLUDE_MY_LOG_TIMESTAMP_HPP_
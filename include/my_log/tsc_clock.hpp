@@ -0,0 +1,303 @@
+///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
+/// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
+///
+/// Use of this source code is governed by a MIT license
+/// that can be found in the License file.
+///
+/// @file   tsc_clock.hpp
+/// @brief  基于CPU时间戳计数器(TSC)的时钟, 定期与系统时间校准
+///
+/// @author lijiancong, pipinstall@163.com
+/// @date   2026-10-17 16:20:37
+///////// ///////// ///////// ///////// ///////// ///////// ///////// /////////
+
+#ifndef INCLUDE_MY_LOG_TSC_CLOCK_HPP_
+#define INCLUDE_MY_LOG_TSC_CLOCK_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define LEE_HAS_RDTSC 1
+#elif (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#include <x86intrin.h>
+#define LEE_HAS_RDTSC 1
+#else
+#define LEE_HAS_RDTSC 0
+#endif
+
+namespace lee {
+inline namespace os {
+/// 日志时间戳的来源
+enum class clock_source {
+  system,  ///< std::chrono::system_clock
+  tsc      ///< CPU时间戳计数器, 格式化时再换算成系统时间
+};
+
+/// @name     tsc_clock
+/// @brief    热路径只读 TSC, 换算成系统时间的工作推迟到格式化时进行
+/// @details  换算参数(基准 TSC、基准系统时间、每纳秒的 tick 数)由 seqlock
+///           保护; 距上次校准超过 CALIBRATION_INTERVAL 后, 第一个进行换算的
+///           线程顺便重新校准, 其他线程继续使用旧参数, 不会被阻塞.
+///           CPU 不支持 invariant TSC 时(或非 x86 平台)退化为 steady_clock.
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 16:22:05
+/// @warning  线程安全; 第一次调用 get_instance 时会睡眠 5ms 估算 TSC 频率
+class tsc_clock {
+ public:
+  static constexpr std::chrono::milliseconds CALIBRATION_INTERVAL{1000};
+
+  static tsc_clock &get_instance() {
+    static std::once_flag flag;
+    static tsc_clock *instance = nullptr;
+    std::call_once(flag, [&]() { instance = new tsc_clock(); });
+    return *instance;
+  }
+
+  /// CPU 是否有 invariant TSC(频率恒定, 不受节能和睡眠状态影响)
+  static bool invariant_tsc_supported() {
+#if LEE_HAS_RDTSC
+#ifdef _MSC_VER
+    int regs[4] = {0};
+    __cpuid(regs, 0x80000000);
+    if (static_cast<unsigned>(regs[0]) < 0x80000007u) {
+      return false;
+    }
+    __cpuid(regs, 0x80000007);
+    return (regs[3] & (1 << 8)) != 0;
+#else
+    unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) {
+      return false;
+    }
+    return (edx & (1u << 8)) != 0;
+#endif
+#else
+    return false;
+#endif
+  }
+
+  /// 热路径: 读取当前的 tick, 不支持 TSC 时为 steady_clock 的纳秒数
+  inline std::uint64_t ticks() const {
+#if LEE_HAS_RDTSC
+    if (use_tsc_) {
+      return __rdtsc();
+    }
+#endif
+    return steady_ns_();
+  }
+
+  bool using_tsc() const { return use_tsc_; }
+
+  /// 两个 tick 之差换算为纳秒
+  double ticks_to_ns(std::uint64_t delta) const {
+    return static_cast<double>(delta) /
+           ticks_per_ns_.load(std::memory_order_relaxed);
+  }
+
+  /// @name     to_time_point
+  /// @brief    把 ticks() 的返回值换算为系统时间
+  ///
+  /// @param    tick  [in]  ticks() 的返回值
+  ///
+  /// @return   对应的系统时间
+  ///
+  /// @author   Lijiancong, pipinstall@163.com
+  /// @date     2026-10-17 16:26:44
+  /// @warning  线程安全
+  std::chrono::system_clock::time_point to_time_point(std::uint64_t tick) {
+    std::uint64_t base_tick;
+    std::int64_t base_ns;
+    double ticks_per_ns;
+    read_calibration_(base_tick, base_ns, ticks_per_ns);
+    if (tick > base_tick &&
+        static_cast<double>(tick - base_tick) > interval_ticks_(ticks_per_ns)) {
+      calibrate();
+      read_calibration_(base_tick, base_ns, ticks_per_ns);
+    }
+    const double delta = tick >= base_tick
+                             ? static_cast<double>(tick - base_tick)
+                             : -static_cast<double>(base_tick - tick);
+    const auto ns = base_ns + static_cast<std::int64_t>(delta / ticks_per_ns);
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::nanoseconds(ns)));
+  }
+
+  /// 重新校准, 已有线程在校准时直接返回
+  void calibrate() {
+    std::unique_lock<std::mutex> lock(calibrate_mutex_, std::try_to_lock);
+    if (!lock.owns_lock()) {
+      return;
+    }
+    std::uint64_t tick;
+    std::int64_t ns;
+    sample_(tick, ns);
+    /// 用上次校准到现在的整段时间估算频率, 间隔越长越准确
+    double ticks_per_ns = ticks_per_ns_.load(std::memory_order_relaxed);
+    if (ns - first_ns_ > 0 && tick > first_tick_) {
+      ticks_per_ns = static_cast<double>(tick - first_tick_) /
+                     static_cast<double>(ns - first_ns_);
+    }
+    write_calibration_(tick, ns, ticks_per_ns);
+  }
+
+ private:
+  tsc_clock() : use_tsc_(invariant_tsc_supported()) {
+    sample_(first_tick_, first_ns_);
+    if (!use_tsc_) {
+      write_calibration_(first_tick_, first_ns_, 1.0);
+      return;
+    }
+    /// 先用一小段时间估算频率, 之后在 calibrate 中逐步修正
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    std::uint64_t tick;
+    std::int64_t ns;
+    sample_(tick, ns);
+    write_calibration_(
+        tick, ns,
+        static_cast<double>(tick - first_tick_) /
+            static_cast<double>(ns > first_ns_ ? ns - first_ns_ : 1));
+  }
+
+  static std::uint64_t steady_ns_() {
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+  }
+
+  static std::int64_t system_ns_() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+  }
+
+  /// 取一对尽量同时的 (tick, 系统时间), 取两次 tick 的中点
+  void sample_(std::uint64_t &tick, std::int64_t &ns) const {
+    auto before = ticks();
+    ns = system_ns_();
+    auto after = ticks();
+    std::uint64_t best_gap = after - before;
+    tick = before + best_gap / 2;
+    for (int i = 1; i < 5; ++i) {
+      before = ticks();
+      const auto now = system_ns_();
+      after = ticks();
+      if (after - before < best_gap) {
+        best_gap = after - before;
+        tick = before + (after - before) / 2;
+        ns = now;
+      }
+    }
+  }
+
+  double interval_ticks_(double ticks_per_ns) const {
+    return ticks_per_ns *
+           std::chrono::duration_cast<std::chrono::nanoseconds>(
+               CALIBRATION_INTERVAL)
+               .count();
+  }
+
+  void read_calibration_(std::uint64_t &base_tick, std::int64_t &base_ns,
+                         double &ticks_per_ns) const {
+    for (;;) {
+      const auto seq = seq_.load(std::memory_order_acquire);
+      if (seq & 1) {
+        std::this_thread::yield();
+        continue;
+      }
+      base_tick = base_tick_.load(std::memory_order_relaxed);
+      base_ns = base_ns_.load(std::memory_order_relaxed);
+      ticks_per_ns = ticks_per_ns_.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (seq_.load(std::memory_order_relaxed) == seq) {
+        return;
+      }
+    }
+  }
+
+  void write_calibration_(std::uint64_t base_tick, std::int64_t base_ns,
+                          double ticks_per_ns) {
+    const auto seq = seq_.load(std::memory_order_relaxed);
+    seq_.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    base_tick_.store(base_tick, std::memory_order_relaxed);
+    base_ns_.store(base_ns, std::memory_order_relaxed);
+    ticks_per_ns_.store(ticks_per_ns, std::memory_order_relaxed);
+    seq_.store(seq + 2, std::memory_order_release);
+  }
+
+  const bool use_tsc_;
+  std::uint64_t first_tick_ = 0;
+  std::int64_t first_ns_ = 0;
+  std::mutex calibrate_mutex_;
+  std::atomic<std::uint64_t> seq_{0};
+  std::atomic<std::uint64_t> base_tick_{0};
+  std::atomic<std::int64_t> base_ns_{0};
+  std::atomic<double> ticks_per_ns_{1.0};
+};
+
+/// @name     log_clock
+/// @brief    日志用的时钟, 可在系统时钟与 TSC 之间切换
+/// @details  第一次使用 TSC 时(set_source(clock_source::tsc), 或首次换算
+///           TSC 时间戳)要构造 tsc_clock, 调用线程会睡眠 5ms 完成首次校准
+///
+/// @author   Lijiancong, pipinstall@163.com
+/// @date     2026-10-17 16:35:19
+/// @warning  线程安全
+class log_clock {
+ public:
+  /// 记录时刻的原始值, 格式化时通过 to_time_point 换算
+  struct time_stamp {
+    std::uint64_t value = 0;
+    clock_source source = clock_source::system;
+  };
+
+  static void set_source(clock_source source) {
+    if (source == clock_source::tsc) {
+      (void)tsc_clock::get_instance();  ///< 在热路径之外完成首次校准
+    }
+    source_.store(source, std::memory_order_relaxed);
+  }
+
+  static clock_source source() {
+    return source_.load(std::memory_order_relaxed);
+  }
+
+  static time_stamp now() {
+    time_stamp stamp;
+    stamp.source = source();
+    if (stamp.source == clock_source::tsc) {
+      stamp.value = tsc_clock::get_instance().ticks();
+    } else {
+      stamp.value = static_cast<std::uint64_t>(
+          std::chrono::system_clock::now().time_since_epoch().count());
+    }
+    return stamp;
+  }
+
+  static std::chrono::system_clock::time_point to_time_point(
+      const time_stamp &stamp) {
+    if (stamp.source == clock_source::tsc) {
+      return tsc_clock::get_instance().to_time_point(stamp.value);
+    }
+    return std::chrono::system_clock::time_point(
+        std::chrono::system_clock::duration(
+            static_cast<std::chrono::system_clock::rep>(stamp.value)));
+  }
+
+ private:
+  static inline std::atomic<clock_source> source_{clock_source::system};
+};
+}  // namespace os
+}  // namespace lee
+
+#endif  // INCLUDE_MY_LOG_TSC_CLOCK_HPP_
@@ -19,11 +19,14 @@
 #include <Windows.h>
 #include <psapi.h>
 #else
+#include <fcntl.h>
 #include <sys/resource.h>
 #include <sys/time.h>
+#include <unistd.h>
 #endif
 
 #include <chrono>
+#include <cstring>
 #include <ctime>
 #include <exception>
 #include <iostream>
@@ -31,11 +34,16 @@
 #include <mutex>
 #include <ratio>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <utility>
 
+#include "my_log/format_number.hpp"
 #include "my_log/log.hpp"
+#include "my_log/os.hpp"
+#include "my_log/tsc_clock.hpp"
 
 namespace lee {
 namespace profiler {
@@ -50,7 +58,7 @@ class profiler_log_wrapper {
     std::call_once(flag, [&]() { instance = new profiler_log_wrapper(); });
     return *instance;
   }
-  void log(const std::string& log) {
+  void log(std::string_view log) {
     profiler_logger->log(log);
     profiler_logger->flush();
   }
@@ -58,11 +66,11 @@ class profiler_log_wrapper {
 
  private:
   profiler_log_wrapper() {
-    profiler_logger = new lee::rotating_file_sink<std::mutex>(
+    profiler_logger = new lee::rotating_file_sink<lee::default_sink_mutex>(
         std::string("log/profiler/profiler.log"));
     profiler_logger->set_level(DEFAULT_PROFILER_LOG_LEVEL);
   }
-  lee::rotating_file_sink<std::mutex>* profiler_logger = nullptr;
+  lee::rotating_file_sink<lee::default_sink_mutex>* profiler_logger = nullptr;
 };
 
 class ProfilerInstance {
@@ -73,54 +81,46 @@ class ProfilerInstance {
       DurationTime;  //单位秒
   enum class MemoryUnit { KB_, MB_, GB_ };
 
-  ProfilerInstance(const std::thread::id thread_id, const std::string& sFunc,
-                   const std::string& sFile, const int iLine)
+  /// sFunc 和 sFile 须在对象的整个生存期内有效, 通常是 __func__ 和
+  /// LEE_FILE_BASENAME; 传入的文件名不再去掉路径
+  ProfilerInstance(const std::thread::id thread_id, const char* sFunc,
+                   const char* sFile, const int iLine)
       : m_Func(sFunc),
         m_File(sFile),
         m_Line(iLine),
-        duringTime(0),
-        startTime(SteadyClock::now()),
-        finishTime(SteadyClock::now()) {
-    if (m_File.find_last_of('/') != std::string::npos) {
-      m_File = m_File.substr(m_File.find_last_of('/') + 1);
-    }
-    std::ostringstream oss;
-    oss << thread_id;
-    pid_ = oss.str();
+        duringTime(0) {
+    (void)thread_id;
+    identity_ = lee::current_thread_identity_ptr();
     start();
   }
 
+  /// 每个线程复用同一个缓冲区拼接, 预热之后不再分配内存
   ~ProfilerInstance() {
     finish();
-    std::string millsec = std::to_string(millisecond());
-    if (millsec.find('.') != std::string::npos) {
-      millsec = millsec.substr(0, millsec.find('.') + 3 + 1);
-    }
-    std::string sec = std::to_string(second());
-    if (sec.find('.') != std::string::npos) {
-      sec = millsec.substr(0, sec.find('.') + 3 + 1);
-    }
-    std::string log;
-    log += lee::get_time_string();
+    thread_local std::string log;
+    log.clear();
+    char buf[lee::MAX_NUMBER_SIZE];
+    log.append(buf, lee::format_timestamp(buf, std::chrono::system_clock::now()));
     log += "[profiler]";
     log += "Spend time: ";
-    log += millsec;
+    append_number_(log, buf, lee::format_float(buf, millisecond(), 3));
     log += " ms(";
-    log += sec;
+    append_number_(log, buf, lee::format_float(buf, second(), 3));
     log += " s), ";
     log += "Member usage: ";
-    log += std::to_string(memory(MemoryUnit::MB_));
+    const auto kb = memory();
+    append_number_(log, buf, lee::format_int(buf, kb / 1024));
     log += " MB(";
-    log += std::to_string(memory());
+    append_number_(log, buf, lee::format_int(buf, kb));
     log += " KB)";
     log += " <In Function: ";
     log += m_Func;
     log += ", File: ";
     log += m_File;
     log += ", Line: ";
-    log += std::to_string(m_Line);
-    log += ", PID: ";
-    log += pid_;
+    append_number_(log, buf, lee::format_int(buf, m_Line));
+    log += ", ";
+    log += identity_->rendered;
     log += ">\n";
     lee::profiler::profiler_log_wrapper::get_instance().log(log);
   }
@@ -130,25 +130,25 @@ class ProfilerInstance {
 #define MB KB / 1024
 #define GB MB / 1024
  private:
-  std::string m_Func;  ///< 传入的需要分析的函数名
-  std::string m_File;  ///< 传入的当前分析在那个文件
+  const char* m_Func;  ///< 传入的需要分析的函数名
+  const char* m_File;  ///< 传入的当前分析在那个文件
   int m_Line;          ///< 传入的当前分析在哪一行
-  std::string pid_;
+  std::shared_ptr<const lee::thread_identity> identity_;  ///< 本线程缓存的线程标识
   DurationTime duringTime;
-  TimePoint startTime;
-  TimePoint finishTime;
+  std::uint64_t startTicks = 0;  ///< tsc_clock 的 tick
+  std::uint64_t finishTicks = 0;
 
  public:
   void start()  // 开始计时
   {
-    startTime = SteadyClock::now();
+    startTicks = lee::tsc_clock::get_instance().ticks();
   }
 
   void finish()  // 结束计时
   {
-    finishTime = SteadyClock::now();
-    duringTime =
-        std::chrono::duration_cast<DurationTime>(finishTime - startTime);
+    auto& clock = lee::tsc_clock::get_instance();
+    finishTicks = clock.ticks();
+    duringTime = DurationTime(clock.ticks_to_ns(finishTicks - startTicks) / 1e9);
   }
 
   void dumpDuringTime(std::ostream& os = std::cout)  // 打印时间
@@ -204,6 +204,11 @@ class ProfilerInstance {
 #endif
     return memory;
   }
+  static void append_number_(std::string& out, const char* begin,
+                             const char* end) {
+    out.append(begin, static_cast<std::size_t>(end - begin));
+  }
+
   int get_sys_mem_use() {  //获取系统当前可用内存
     int mem_free = -1;     //空闲的内存，=总内存-使用了的内存
     int mem_total = -1;    //当前系统可用总内存
@@ -211,24 +216,22 @@ class ProfilerInstance {
     /// int mem_cached = -1;   //缓存区的内存大小
     char name[20];
 
-    FILE* fp;
-    char buf1[128], buf2[128], buf3[128], buf4[128], buf5[128];
-    int buff_len = 128;
-    fp = fopen("/proc/meminfo", "r");
-    if (fp == nullptr) {
-      fclose(fp);
+    /// 用 open/read 读到栈上, 不像 fopen 那样每次分配 FILE 和它的缓冲区
+    char buf1[512];
+    const int fd = ::open("/proc/meminfo", O_RDONLY);
+    if (fd < 0) {
       throw std::runtime_error("GetSysMemInfo() error! file not exist");
     }
-    if (nullptr == fgets(buf1, buff_len, fp) ||
-        nullptr == fgets(buf2, buff_len, fp) ||
-        nullptr == fgets(buf3, buff_len, fp) ||
-        nullptr == fgets(buf4, buff_len, fp) ||
-        nullptr == fgets(buf5, buff_len, fp)) {
-      fclose(fp);
+    const auto n = ::read(fd, buf1, sizeof(buf1) - 1);
+    ::close(fd);
+    if (n <= 0) {
+      throw std::runtime_error("GetSysMemInfo() error! fail to read!");
+    }
+    buf1[n] = '\0';
+    const char* buf2 = std::strchr(buf1, '\n');
+    if (buf2 == nullptr) {
       throw std::runtime_error("GetSysMemInfo() error! fail to read!");
-      return -1;
     }
-    fclose(fp);
     sscanf(buf1, "%s%d", name, &mem_total);
     sscanf(buf2, "%s%d", name, &mem_free);
     /// sscanf(buf4, "%s%d", name, &mem_buffers);
@@ -245,7 +248,8 @@ class ProfilerInstance {
 #ifdef LEE_C11_PROFILER_MODE
 #define PROFILER_F()                                                     \
   lee::profiler::ProfilerInstance pRoFiLeR__(std::this_thread::get_id(), \
-                                             __func__, __FILE__, __LINE__)
+                                             __func__, LEE_FILE_BASENAME, \
+                                             __LINE__)
 #else
 #define PROFILER_F() nullptr
 #endif  // end of LEE_C11_PROFILER_MODE
@@ -0,0 +1,36 @@
+/// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
+///
+/// Use of this source code is governed by a MIT license
+/// that can be found in the License file.
+
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+#include "my_log/binary_log.hpp"
+
+/// 把 LOG_BINARY 写出的二进制日志还原为文本日志, 输出到标准输出
+/// 用法: my_log_decoder log/binary/binary_log.bin [更多文件...]
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cerr << "usage: " << argv[0] << " <binary log file>..." << std::endl;
+    return 1;
+  }
+  int ret = 0;
+  for (int i = 1; i < argc; ++i) {
+    std::ifstream in(argv[i], std::ifstream::binary);
+    if (!in) {
+      std::cerr << argv[i] << ": failed to open" << std::endl;
+      ret = 1;
+      continue;
+    }
+    try {
+      lee::binary_decoder decoder;
+      decoder.decode(in, std::cout);
+    } catch (const std::runtime_error& e) {
+      std::cerr << argv[i] << ": " << e.what() << std::endl;
+      ret = 1;
+    }
+  }
+  return ret;
+}
@@ -4,6 +4,7 @@
 /// that can be found in the License file.
 
 #define CATCH_CONFIG_RUNNER
+#define CATCH_CONFIG_NO_POSIX_SIGNALS
 #include <catch2/catch.hpp>
 #include <iostream>
 
@@ -11,6 +12,5 @@
 #include "profiler.hpp"
 
 int main(int argc, char** argv) {
-  Catch::Session().run(argc, argv);
-  return 0;
+  return Catch::Session().run(argc, argv);
 }
@@ -0,0 +1,81 @@
+/// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
+///
+/// Use of this source code is governed by a MIT license
+/// that can be found in the License file.
+///
+/// 单独编译成 my_log_allocation_test: 替换全局 operator new 统计堆分配次数,
+/// 检查日志宏在预热之后不再分配内存
+
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <cstdlib>
+#include <new>
+
+#include "log_stream.hpp"
+#include "log_wrapper.hpp"
+#include "profiler.hpp"
+
+namespace {
+std::atomic<std::size_t> allocation_count{0};
+
+void* counted_malloc(std::size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+/// 预热之后执行 n 次 f, 返回期间的分配次数
+template <typename F>
+std::size_t count_allocations(F&& f, int n = 100) {
+  f();
+  const auto before = allocation_count.load(std::memory_order_relaxed);
+  for (int i = 0; i < n; ++i) {
+    f();
+  }
+  return allocation_count.load(std::memory_order_relaxed) - before;
+}
+}  // namespace
+
+void* operator new(std::size_t size) { return counted_malloc(size); }
+void* operator new[](std::size_t size) { return counted_malloc(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+TEST_CASE("LOG_* steady state allocations", "[my_log][allocation]") {
+  const std::string name = "request";
+  auto allocations = count_allocations([&name] {
+    LOG_INFO("x");
+    LOG_INFO(lee::lazy_concat() + name + " took " + 42 + "ms");
+    LOG_ERROR("error " + name);
+  });
+  REQUIRE(allocations == 0);
+
+  allocations = count_allocations([] { LOG_INFO_FMT("{} took {}ms", 1, 2.5); });
+  REQUIRE(allocations == 0);
+}
+
+TEST_CASE("LOG(X) steady state allocations", "[my_log][allocation]") {
+  const auto allocations = count_allocations([] {
+    LOG(INFO) << "x";
+    LOG(WARN) << "value " << 42 << ' ' << 0.5;
+  });
+  REQUIRE(allocations == 0);
+}
+
+TEST_CASE("PROFILER_F steady state allocations", "[my_log][allocation]") {
+  const auto allocations = count_allocations([] { PROFILER_F(); });
+  REQUIRE(allocations == 0);
+}
+
+TEST_CASE("long lines reuse the thread pool", "[my_log][allocation]") {
+  const std::string payload(lee::DEFAULT_INLINE_BUFFER_SIZE * 2, 'x');
+  const auto allocations = count_allocations([&payload] {
+    LOG(INFO) << payload;
+    LOG_INFO(lee::lazy_concat() + "long " + payload);
+  });
+  REQUIRE(allocations == 0);
+}
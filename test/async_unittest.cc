@@ -0,0 +1,264 @@
+/// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
+///
+/// Use of this source code is governed by a MIT license
+/// that can be found in the License file.
+
+#include "my_log/async.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "log_wrapper.hpp"
+#include "my_log/thread_ring.hpp"
+#include "profiler.hpp"
+
+namespace {
+lee::async_msg make_msg(const std::string& text) {
+  lee::async_msg msg;
+  msg.level = lee::level_enum::info;
+  msg.msg = text;
+  return msg;
+}
+
+std::string read_file_tail(const std::string& filename, std::size_t bytes) {
+  std::ifstream ifs(filename, std::ifstream::ate | std::ifstream::binary);
+  auto size = static_cast<std::size_t>(ifs.tellg());
+  auto offset = size > bytes ? size - bytes : 0;
+  ifs.seekg(static_cast<std::streamoff>(offset));
+  std::string tail(size - offset, '\0');
+  ifs.read(&tail[0], static_cast<std::streamsize>(tail.size()));
+  return tail;
+}
+}  // namespace
+
+TEST_CASE("mpmc_blocking_queue drop_newest", "[my_log][async]") {
+  lee::mpmc_blocking_queue<lee::async_msg> q(2);
+  REQUIRE(q.enqueue(make_msg("1"), lee::overflow_policy::drop_newest));
+  REQUIRE(q.enqueue(make_msg("2"), lee::overflow_policy::drop_newest));
+  REQUIRE_FALSE(q.enqueue(make_msg("3"), lee::overflow_policy::drop_newest));
+  REQUIRE(q.counters().dropped_newest == 1);
+  REQUIRE(q.counters().overwritten_oldest == 0);
+
+  lee::async_msg out;
+  REQUIRE(q.dequeue_for(out, std::chrono::milliseconds(0)));
+  REQUIRE(out.msg == "1");
+  REQUIRE(q.dequeue_for(out, std::chrono::milliseconds(0)));
+  REQUIRE(out.msg == "2");
+  REQUIRE_FALSE(q.dequeue_for(out, std::chrono::milliseconds(0)));
+}
+
+TEST_CASE("mpmc_blocking_queue overwrite_oldest", "[my_log][async]") {
+  lee::mpmc_blocking_queue<lee::async_msg> q(2);
+  for (int i = 1; i <= 5; ++i) {
+    REQUIRE(q.enqueue(make_msg(std::to_string(i)),
+                      lee::overflow_policy::overwrite_oldest));
+  }
+  REQUIRE(q.counters().overwritten_oldest == 3);
+  REQUIRE(q.size() == 2);
+
+  lee::async_msg out;
+  REQUIRE(q.dequeue_for(out, std::chrono::milliseconds(0)));
+  REQUIRE(out.msg == "4");
+  REQUIRE(q.dequeue_for(out, std::chrono::milliseconds(0)));
+  REQUIRE(out.msg == "5");
+}
+
+TEST_CASE("async_worker drains on stop", "[my_log][async]") {
+  std::size_t handled = 0;
+  {
+    lee::async_worker worker(
+        4, lee::overflow_policy::block,
+        [&handled](const lee::async_msg&) { ++handled; });
+    for (int i = 0; i < 1000; ++i) {
+      worker.post_log(lee::level_enum::info, std::to_string(i));
+    }
+    worker.stop();
+    REQUIRE(worker.counters().dropped_newest == 0);
+  }
+  REQUIRE(handled == 1000);
+}
+
+TEST_CASE("async_worker stop wakes producers blocked on a full queue",
+          "[my_log][async]") {
+  std::atomic<bool> entered{false};
+  std::atomic<bool> release{false};
+  std::atomic<int> handled{0};
+  lee::async_worker worker(1, lee::overflow_policy::block,
+                           [&](const lee::async_msg&) {
+                             entered = true;
+                             while (!release.load()) {
+                               std::this_thread::yield();
+                             }
+                             ++handled;
+                           });
+  /// 第一条卡在 handler 里, 第二条占满队列, 第三条等待空间
+  REQUIRE(worker.post_log(lee::level_enum::info, "0"));
+  for (int i = 0; i < 5000 && !entered; ++i) {
+    lee::sleep_for_millis(1);
+  }
+  REQUIRE(entered);
+  std::atomic<int> accepted{1};
+  std::thread producer([&] {
+    for (int i = 1; i < 3; ++i) {
+      accepted += worker.post_log(lee::level_enum::info, std::to_string(i));
+    }
+  });
+  for (int i = 0; i < 5000 && worker.counters().blocked == 0; ++i) {
+    lee::sleep_for_millis(1);
+  }
+  REQUIRE(worker.counters().blocked == 1);
+
+  std::thread stopper([&worker] { worker.stop(); });
+  producer.join();
+  REQUIRE(accepted == 2);
+  REQUIRE_FALSE(worker.post_log(lee::level_enum::info, "after stop"));
+  release = true;
+  stopper.join();
+  REQUIRE(handled == 2);
+}
+
+TEST_CASE("spsc_ring", "[my_log][async]") {
+  lee::spsc_ring<int> ring(3);
+  REQUIRE(ring.capacity() == 4);
+  for (int i = 0; i < 4; ++i) {
+    int v = i;
+    REQUIRE(ring.try_push(std::move(v)));
+  }
+  int v = 4;
+  REQUIRE_FALSE(ring.try_push(std::move(v)));
+  for (int i = 0; i < 4; ++i) {
+    REQUIRE(ring.front() != nullptr);
+    REQUIRE(*ring.front() == i);
+    ring.pop();
+  }
+  REQUIRE(ring.front() == nullptr);
+}
+
+TEST_CASE("thread_ring_worker merges and recycles rings", "[my_log][async]") {
+  constexpr int THREADS = 4;
+  constexpr int PER_THREAD = 2000;
+  std::vector<std::vector<int>> seen(THREADS);
+  std::atomic<int> handled{0};
+  lee::thread_ring_worker worker(
+      64, lee::overflow_policy::block,
+      [&](const lee::async_msg& msg) {
+        auto pos = msg.msg.find(':');
+        seen[std::stoi(msg.msg.substr(0, pos))].push_back(
+            std::stoi(msg.msg.substr(pos + 1)));
+        ++handled;
+      },
+      std::chrono::microseconds(50));
+
+  auto run_wave = [&worker] {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+      threads.emplace_back([&worker, t] {
+        for (int i = 0; i < PER_THREAD; ++i) {
+          worker.post_log(lee::level_enum::info,
+                          std::to_string(t) + ":" + std::to_string(i));
+        }
+      });
+    }
+    for (auto& it : threads) {
+      it.join();
+    }
+  };
+
+  run_wave();
+  for (int i = 0; i < 1000 && handled < THREADS * PER_THREAD; ++i) {
+    lee::sleep_for_millis(1);
+  }
+  REQUIRE(handled == THREADS * PER_THREAD);
+  for (auto& it : seen) {
+    REQUIRE(it.size() == PER_THREAD);
+    REQUIRE(std::is_sorted(it.begin(), it.end()));
+  }
+  /// 等后台线程把已退出线程的队列回收, 第二批线程应复用它们
+  lee::sleep_for_millis(20);
+  run_wave();
+  worker.stop();
+  REQUIRE(handled == 2 * THREADS * PER_THREAD);
+  REQUIRE(worker.ring_count() == THREADS);
+  REQUIRE(worker.counters().dropped_newest == 0);
+}
+
+TEST_CASE("log_wrapper thread_ring mode", "[my_log][async]") {
+  auto& wrapper = lee::log_wrapper::get_instance();
+  wrapper.enable_async(128, lee::overflow_policy::block,
+                       lee::async_mode::thread_ring);
+  {
+    PROFILER_F();
+    for (auto x = 0; x < 1000; x++) {
+      LOG_INFO("thread_ring info " + std::to_string(x));
+    }
+  }
+  LOG_ERROR("thread_ring last record");
+  wrapper.disable_async();
+  REQUIRE(read_file_tail("log/detail/detail_log.log", 4096)
+              .find("thread_ring last record") != std::string::npos);
+}
+
+TEST_CASE("log_wrapper async mode", "[my_log][async]") {
+  auto& wrapper = lee::log_wrapper::get_instance();
+  wrapper.enable_async(128, lee::overflow_policy::block);
+  REQUIRE(wrapper.is_async());
+  {
+    PROFILER_F();
+    for (auto x = 0; x < 1000; x++) {
+      LOG_INFO("async info " + std::to_string(x));
+    }
+  }
+  LOG_ERROR("async last record");
+  wrapper.disable_async();
+  REQUIRE_FALSE(wrapper.is_async());
+  REQUIRE(wrapper.async_overflow_counters().dropped_newest == 0);
+  REQUIRE(read_file_tail("log/detail/detail_log.log", 4096)
+              .find("async last record") != std::string::npos);
+}
+
+TEST_CASE("log_wrapper disable_async while other threads keep logging",
+          "[my_log][async]") {
+  constexpr int THREADS = 4;
+  constexpr int PER_THREAD = 5000;
+  auto& wrapper = lee::log_wrapper::get_instance();
+  auto counted = std::make_shared<lee::counting_sink<std::mutex>>();
+  wrapper.add_sink(counted);
+  wrapper.set_console_log_level(lee::level_enum::critical);
+
+  std::atomic<bool> done{false};
+  std::vector<std::thread> producers;
+  for (int t = 0; t < THREADS; ++t) {
+    producers.emplace_back([] {
+      for (int i = 0; i < PER_THREAD; ++i) {
+        LOG_INFO(lee::lazy_concat() + "toggle " + i);
+      }
+    });
+  }
+  /// 生产者一直在写, 反复开关异步模式; 被拒绝的记录改为同步写入, 一条不少
+  std::thread toggler([&wrapper, &done] {
+    for (int round = 0; !done.load(); ++round) {
+      wrapper.enable_async(8, lee::overflow_policy::block,
+                           round % 2 == 0 ? lee::async_mode::shared_queue
+                                          : lee::async_mode::thread_ring);
+      std::this_thread::yield();
+      wrapper.disable_async();
+    }
+  });
+  for (auto& it : producers) {
+    it.join();
+  }
+  done = true;
+  toggler.join();
+
+  REQUIRE_FALSE(wrapper.is_async());
+  REQUIRE(counted->count(lee::level_enum::info) == THREADS * PER_THREAD);
+  wrapper.set_console_log_level(lee::DEFAULT_COUT_LOG_LEVEL);
+  REQUIRE(wrapper.remove_sink(counted));
+}
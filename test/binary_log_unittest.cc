@@ -0,0 +1,182 @@
+/// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
+///
+/// Use of this source code is governed by a MIT license
+/// that can be found in the License file.
+
+#include "my_log/binary_log.hpp"
+
+#include <catch2/catch.hpp>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "profiler.hpp"
+
+namespace {
+std::string decode_file(const std::string& filename) {
+  std::ifstream in(filename, std::ifstream::binary);
+  std::ostringstream out;
+  lee::binary_decoder decoder;
+  decoder.decode(in, out);
+  return out.str();
+}
+}  // namespace
+
+TEST_CASE("binary_log decode", "[my_log][binary_log]") {
+  const std::string filename = "test_logs/binary_decode.bin";
+  lee::remove_if_exists(filename);
+  {
+    lee::binary_logger logger(filename);
+    static lee::binary_site site{lee::level_enum::warn,
+                                 "{} took {} ms, ok: {}, c: {}, {{x}}",
+                                 "dir/sub/binary.cc", "func", 42};
+    logger.log(site, site.format, std::string("query"), 12.5, true, 'c');
+    logger.log(site, site.format, "select", -3, false, 'd');
+    logger.flush();
+  }
+  auto text = decode_file(filename);
+  REQUIRE(text.find(
+              "[warn]  query took 12.5 ms, ok: true, c: c, {x} <In Function: "
+              "func, File: binary.cc, Line: 42, TID: " +
+              std::to_string(lee::thread_id()) + ">") != std::string::npos);
+  REQUIRE(text.find("[warn]  select took -3 ms, ok: false, c: d") !=
+          std::string::npos);
+}
+
+TEST_CASE("binary_log decodes doubles without losing digits",
+          "[my_log][binary_log]") {
+  const std::string filename = "test_logs/binary_double.bin";
+  lee::remove_if_exists(filename);
+  {
+    lee::binary_logger logger(filename);
+    static lee::binary_site site{lee::level_enum::info, "px {} qty {} f {}",
+                                 __FILE__, __func__, __LINE__};
+    logger.log(site, site.format, 0.1234567, 1234567.891, 0.1f);
+    logger.flush();
+  }
+  auto text = decode_file(filename);
+  /// 与文本日志的 format_float 输出一致, float 按 double 记录
+  char buf[lee::MAX_FLOAT_SIZE];
+  const std::string f(buf, lee::format_float(buf, static_cast<double>(0.1f)));
+  REQUIRE(text.find("px 0.1234567 qty 1234567.891 f " + f + " ") !=
+          std::string::npos);
+}
+
+TEST_CASE("binary_log rotation keeps sites", "[my_log][binary_log]") {
+  const std::string filename = "test_logs/binary_rotate.bin";
+  for (std::size_t i = 0; i <= 2; ++i) {
+    lee::remove_if_exists(
+        lee::rotating_file_sink<std::mutex>::calc_filename(filename, i));
+  }
+  {
+    lee::binary_logger logger(filename, 1024, 2);
+    static lee::binary_site site{lee::level_enum::info, "value {}",
+                                 __FILE__, __func__, __LINE__};
+    for (int i = 0; i < 200; ++i) {
+      logger.log(site, site.format, i);
+    }
+    logger.flush();
+  }
+  /// 滚动后的每个文件都能独立解码
+  auto last = decode_file(filename);
+  auto previous = decode_file(
+      lee::rotating_file_sink<std::mutex>::calc_filename(filename, 1));
+  REQUIRE(last.find("value 199 ") != std::string::npos);
+  REQUIRE_FALSE(previous.empty());
+}
+
+TEST_CASE("binary_log keeps the previous run's file", "[my_log][binary_log]") {
+  const std::string filename = "test_logs/binary_restart.bin";
+  for (std::size_t i = 0; i <= 2; ++i) {
+    lee::remove_if_exists(
+        lee::rotating_file_sink<std::mutex>::calc_filename(filename, i));
+  }
+  static lee::binary_site site{lee::level_enum::error, "run {}", __FILE__,
+                               __func__, __LINE__};
+  for (int run = 1; run <= 2; ++run) {
+    lee::binary_logger logger(filename, 1024 * 1024, 2);
+    logger.log(site, site.format, run);
+    logger.flush();
+  }
+  auto previous = decode_file(
+      lee::rotating_file_sink<std::mutex>::calc_filename(filename, 1));
+  auto last = decode_file(filename);
+  REQUIRE(previous.find("run 1 ") != std::string::npos);
+  REQUIRE(last.find("run 2 ") != std::string::npos);
+  REQUIRE(last.find("run 1 ") == std::string::npos);
+}
+
+TEST_CASE("binary_log keeps each thread's order through the staging rings",
+          "[my_log][binary_log]") {
+  const std::string filename = "test_logs/binary_threads.bin";
+  for (std::size_t i = 0; i <= 1; ++i) {
+    lee::remove_if_exists(
+        lee::rotating_file_sink<std::mutex>::calc_filename(filename, i));
+  }
+  constexpr int THREADS = 4;
+  constexpr int PER_THREAD = 5000;
+  static lee::binary_site site{lee::level_enum::info, "seq {} {}", __FILE__,
+                               __func__, __LINE__};
+  {
+    /// 队列很短, 部分记录和超长的记录由调用线程直接写入, 仍不能丢失或乱序
+    lee::binary_logger logger(filename, 1048576 * 50, 1, 16);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < THREADS; ++t) {
+      workers.emplace_back([&logger] {
+        for (int i = 0; i < PER_THREAD; ++i) {
+          logger.log(site, site.format, i,
+                     i % 100 == 0 ? std::string(300, 'x') : std::string("s"));
+        }
+      });
+    }
+    for (auto& it : workers) {
+      it.join();
+    }
+    logger.flush();
+    REQUIRE(logger.staging_overflows() > 0);
+  }
+
+  std::istringstream text(decode_file(filename));
+  std::map<std::string, int> next_seq;
+  int lines = 0;
+  int out_of_order = 0;
+  for (std::string line; std::getline(text, line); ++lines) {
+    const auto seq = line.find("seq ");
+    const auto tid = line.find("TID: ");
+    if (seq == std::string::npos || tid == std::string::npos) {
+      ++out_of_order;
+      continue;
+    }
+    auto& expected = next_seq[line.substr(tid)];
+    out_of_order += std::stoi(line.substr(seq + 4)) == expected ? 0 : 1;
+    ++expected;
+  }
+  REQUIRE(lines == THREADS * PER_THREAD);
+  REQUIRE(out_of_order == 0);
+  REQUIRE(next_seq.size() == THREADS);
+}
+
+TEST_CASE("binary_log macro", "[my_log][binary_log]") {
+  auto& logger = lee::binary_logger::get_instance();
+  for (auto i = 0; i < 10; i++) {
+    PROFILER_F();
+    for (auto x = 0; x < 1000; x++) {
+      LOG_BINARY(info, "binary {} {} {}", "string", x, 55.0);
+    }
+  }
+  LOG_BINARY(critical, "binary without arguments");
+  logger.set_level(lee::level_enum::info);
+  LOG_BINARY(debug, "binary filtered {}", 1);
+  logger.set_level(lee::level_enum::trace);
+  logger.flush();
+
+  auto text = decode_file(logger.filename());
+  REQUIRE(text.find("[info]  binary string 999 55 <In Function: ") !=
+          std::string::npos);
+  REQUIRE(text.find("[critical] binary without arguments") !=
+          std::string::npos);
+  REQUIRE(text.find("binary filtered") == std::string::npos);
+}
@@ -0,0 +1,190 @@
+/// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
+///
+/// Use of this source code is governed by a MIT license
+/// that can be found in the License file.
+
+#include "my_log/dist_sink.hpp"
+
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "log_wrapper.hpp"
+
+namespace {
+lee::log_record make_record(const lee::log_site& site) {
+  lee::log_record record;
+  record.site = &site;
+  record.thread = &lee::current_thread_identity();
+  return record;
+}
+
+/// log 中一直等到 release 被调用, 用来模拟正在进行的日志调用
+class blocking_sink final : public lee::sink {
+ public:
+  void log(const lee::log_record&) override {
+    entered.store(true);
+    while (!released.load()) {
+      std::this_thread::yield();
+    }
+  }
+  void flush() override {}
+
+  std::atomic<bool> entered{false};
+  std::atomic<bool> released{false};
+};
+}  // namespace
+
+TEST_CASE("dist_sink forwards by each child's level", "[my_log][dist_sink]") {
+  auto all = std::make_shared<lee::counting_sink<std::mutex>>();
+  auto errors = std::make_shared<lee::counting_sink<std::mutex>>();
+  errors->set_level(lee::level_enum::error);
+
+  lee::dist_sink dist({all});
+  REQUIRE(dist.min_sink_level() == lee::level_enum::trace);
+  dist.add_sink(errors);
+  REQUIRE(dist.sinks().size() == 2);
+
+  LEE_LOG_SITE(info_site, lee::level_enum::info);
+  LEE_LOG_SITE(error_site, lee::level_enum::error);
+  dist.log(make_record(info_site));
+  dist.log(make_record(error_site));
+  REQUIRE(all->total() == 2);
+  REQUIRE(errors->total() == 1);
+  REQUIRE(errors->count(lee::level_enum::error) == 1);
+
+  REQUIRE(dist.remove_sink(all));
+  REQUIRE_FALSE(dist.remove_sink(all));
+  REQUIRE(dist.min_sink_level() == lee::level_enum::error);
+  dist.log(make_record(error_site));
+  REQUIRE(all->total() == 2);
+  REQUIRE(errors->total() == 2);
+
+  dist.set_sinks({});
+  REQUIRE(dist.sinks().empty());
+  REQUIRE(dist.min_sink_level() == lee::level_enum::off);
+  REQUIRE(dist.reclaim() == 0);
+}
+
+TEST_CASE("dist_sink frees a removed child after in-flight calls",
+          "[my_log][dist_sink]") {
+  lee::dist_sink dist;
+  auto blocker = std::make_shared<blocking_sink>();
+  std::weak_ptr<blocking_sink> watch = blocker;
+  dist.add_sink(blocker);
+
+  LEE_LOG_SITE(site, lee::level_enum::info);
+  std::thread writer([&dist] { dist.log(make_record(site)); });
+  while (!blocker->entered.load()) {
+    std::this_thread::yield();
+  }
+
+  /// 写线程还在旧快照里, 旧快照和它持有的子 sink 都不能释放
+  auto* raw = blocker.get();
+  REQUIRE(dist.remove_sink(blocker));
+  blocker.reset();
+  REQUIRE(dist.sinks().empty());
+  REQUIRE(dist.reclaim() == 1);
+  REQUIRE_FALSE(watch.expired());
+
+  raw->released.store(true);
+  writer.join();
+  REQUIRE(dist.reclaim() == 0);
+  REQUIRE(watch.expired());
+}
+
+TEST_CASE("dist_sink reconfigures while other threads log",
+          "[my_log][dist_sink]") {
+  constexpr int THREADS = 4;
+  constexpr int PER_THREAD = 20000;
+  auto permanent = std::make_shared<lee::counting_sink<std::mutex>>();
+  lee::dist_sink dist({permanent});
+
+  std::atomic<bool> done{false};
+  std::size_t toggles = 0;
+  std::thread configurer([&dist, &done, &toggles] {
+    while (!done.load()) {
+      auto temporary = std::make_shared<lee::counting_sink<std::mutex>>();
+      dist.add_sink(temporary);
+      std::this_thread::yield();
+      dist.remove_sink(temporary);
+      ++toggles;
+    }
+  });
+
+  LEE_LOG_SITE(site, lee::level_enum::info);
+  std::vector<std::thread> writers;
+  for (int t = 0; t < THREADS; ++t) {
+    writers.emplace_back([&dist] {
+      const auto record = make_record(site);
+      for (int i = 0; i < PER_THREAD; ++i) {
+        dist.log(record);
+      }
+    });
+  }
+  for (auto& it : writers) {
+    it.join();
+  }
+  done.store(true);
+  configurer.join();
+
+  REQUIRE(permanent->total() == static_cast<std::size_t>(THREADS) * PER_THREAD);
+  REQUIRE(dist.sinks().size() == 1);
+  REQUIRE(dist.reclaim() == 0);
+  std::cout << "dist_sink reconfigured " << toggles << " times while logging"
+            << std::endl;
+}
+
+TEST_CASE("log_wrapper attaches a sink at runtime", "[my_log][dist_sink]") {
+  auto& wrapper = lee::log_wrapper::get_instance();
+  const auto before = lee::log_wrapper::min_level();
+  auto attached = std::make_shared<lee::counting_sink<std::mutex>>();
+  attached->set_level(lee::level_enum::warn);
+
+  wrapper.add_sink(attached);
+  LOG_WARN("attached sink receives this");
+  LOG_INFO("attached sink filters this");
+  REQUIRE(attached->total() == 1);
+  REQUIRE(lee::log_wrapper::min_level() == before);
+
+  attached->set_level(lee::level_enum::trace);
+  wrapper.refresh_sink_levels();
+  REQUIRE(lee::log_wrapper::min_level() == lee::level_enum::trace);
+
+  REQUIRE(wrapper.remove_sink(attached));
+  LOG_WARN("attached sink no longer receives this");
+  REQUIRE(attached->total() == 1);
+  REQUIRE(lee::log_wrapper::min_level() == before);
+}
+
+TEST_CASE("dist_sink dispatch benchmark", "[my_log][dist_sink]") {
+  constexpr int ITERATIONS = 1000000;
+  auto child = std::make_shared<lee::counting_sink<lee::null_mutex>>();
+  lee::dist_sink dist({child});
+  LEE_LOG_SITE(site, lee::level_enum::info);
+  const auto record = make_record(site);
+
+  const auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < ITERATIONS; ++i) {
+    child->log(record);
+  }
+  const auto middle = std::chrono::steady_clock::now();
+  for (int i = 0; i < ITERATIONS; ++i) {
+    dist.log(record);
+  }
+  const auto end = std::chrono::steady_clock::now();
+
+  REQUIRE(child->total() == 2u * ITERATIONS);
+  std::cout << "direct: "
+            << std::chrono::duration<double, std::nano>(middle - begin).count() /
+                   ITERATIONS
+            << " ns/record, dist_sink: "
+            << std::chrono::duration<double, std::nano>(end - middle).count() /
+                   ITERATIONS
+            << " ns/record" << std::endl;
+}
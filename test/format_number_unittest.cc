@@ -0,0 +1,116 @@
+/// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
+///
+/// Use of this source code is governed by a MIT license
+/// that can be found in the License file.
+
+#include "my_log/format_number.hpp"
+
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <sstream>
+#include <string>
+
+#include "log_wrapper.hpp"
+#include "profiler.hpp"
+
+namespace {
+template <typename T>
+std::string number(T value) {
+  char buf[lee::MAX_NUMBER_SIZE];
+  return std::string(buf, lee::format_number(buf, value));
+}
+
+template <typename T>
+std::string fixed(T value, int precision) {
+  char buf[lee::MAX_FLOAT_SIZE];
+  return std::string(buf, lee::format_float(buf, value, precision));
+}
+
+template <typename T>
+std::string by_stream(T value) {
+  std::ostringstream oss;
+  oss << value;
+  return oss.str();
+}
+}  // namespace
+
+TEST_CASE("format_int", "[my_log][format_number]") {
+  REQUIRE(number(0) == "0");
+  REQUIRE(number(7) == "7");
+  REQUIRE(number(-7) == "-7");
+  REQUIRE(number(10) == "10");
+  REQUIRE(number(99) == "99");
+  REQUIRE(number(100) == "100");
+  REQUIRE(number(12345) == "12345");
+  REQUIRE(number(std::numeric_limits<std::int64_t>::min()) ==
+          by_stream(std::numeric_limits<std::int64_t>::min()));
+  REQUIRE(number(std::numeric_limits<std::int64_t>::max()) ==
+          by_stream(std::numeric_limits<std::int64_t>::max()));
+  REQUIRE(number(std::numeric_limits<std::uint64_t>::max()) ==
+          "18446744073709551615");
+  REQUIRE(number(static_cast<short>(-32768)) == "-32768");
+  for (std::uint64_t n = 1, i = 0; i < 20; ++i, n *= 10) {
+    REQUIRE(number(n) == std::to_string(n));
+    REQUIRE(number(n - 1) == std::to_string(n - 1));
+  }
+}
+
+TEST_CASE("format_float", "[my_log][format_number]") {
+  REQUIRE(number(0.0) == "0");
+  REQUIRE(number(-1.5) == "-1.5");
+  REQUIRE(number(0.1) == "0.1");
+  REQUIRE(number(0.1f) == "0.1");
+  REQUIRE(number(1e300) == "1e+300");
+  for (double value : {3.141592653589793, 1.0 / 3, 2.5e-308, 123456789.125}) {
+    REQUIRE(std::stod(number(value)) == value);
+  }
+  REQUIRE(fixed(3.14159, 2) == "3.14");
+  REQUIRE(fixed(2.0, 3) == "2.000");
+  REQUIRE(fixed(-0.125, 1) == "-0.1");
+}
+
+TEST_CASE("format_hex", "[my_log][format_number]") {
+  char buf[lee::MAX_HEX_SIZE];
+  REQUIRE(std::string(buf, lee::format_hex(buf, 0)) == "0x0");
+  REQUIRE(std::string(buf, lee::format_hex(buf, 255)) == "0xff");
+  REQUIRE(std::string(buf, lee::format_hex(buf, UINT64_MAX)) ==
+          "0xffffffffffffffff");
+  REQUIRE(lee::to_hex(4096) == "0x1000");
+
+  int x = 0;
+  char expected[32];
+  std::snprintf(expected, sizeof(expected), "%p", static_cast<void*>(&x));
+  REQUIRE(lee::pointer_to_hex(&x) == expected);
+  REQUIRE(lee::to_log(&x) == expected);
+  REQUIRE(number(true) == "true");
+  REQUIRE(number('c') == "c");
+  REQUIRE(lee::to_log(42) == "42");
+  REQUIRE(lee::to_log(0.5) == "0.5");
+}
+
+TEST_CASE("format_number benchmark", "[my_log][format_number]") {
+  constexpr int COUNT = 1000000;
+  std::size_t total = 0;
+  {
+    PROFILER_F();
+    std::ostringstream oss;
+    for (int i = 0; i < COUNT; ++i) {
+      oss.str(std::string());
+      oss << static_cast<std::int64_t>(i) * 7919 << ' ' << i * 0.37;
+      total += oss.str().size();
+    }
+  }
+  {
+    PROFILER_F();
+    char buf[2 * lee::MAX_NUMBER_SIZE];
+    for (int i = 0; i < COUNT; ++i) {
+      char* p = lee::format_number(buf, static_cast<std::int64_t>(i) * 7919);
+      *p++ = ' ';
+      p = lee::format_number(p, i * 0.37);
+      total += static_cast<std::size_t>(p - buf);
+    }
+  }
+  REQUIRE(total > 0);
+}
@@ -0,0 +1,93 @@
+/// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
+///
+/// Use of this source code is governed by a MIT license
+/// that can be found in the License file.
+
+#include "my_log/format_range.hpp"
+
+#include <array>
+#include <catch2/catch.hpp>
+#include <forward_list>
+#include <list>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "log_stream.hpp"
+#include "log_wrapper.hpp"
+#include "profiler.hpp"
+
+TEST_CASE("to_log containers", "[my_log][format_range]") {
+  REQUIRE(lee::to_log(std::vector<int>{}) == "[]");
+  REQUIRE(lee::to_log(std::vector<int>{1, 2, 3}) == "[1,2,3]");
+  REQUIRE(lee::to_log(std::vector<std::string>{"a", "b"}) == "[a,b]");
+  REQUIRE(lee::to_log(std::set<int>{3, 1, 2}) == "[1,2,3]");
+  REQUIRE(lee::to_log(std::list<double>{0.5, 1.25}) == "[0.5,1.25]");
+  REQUIRE(lee::to_log(std::array<int, 2>{7, 8}) == "[7,8]");
+  REQUIRE(lee::to_log(std::map<std::string, int>{{"a", 1}, {"b", 2}}) ==
+          "{a:1,b:2}");
+  REQUIRE(lee::to_log(std::make_pair(1, std::string("x"))) == "(1,x)");
+  REQUIRE(lee::to_log(std::make_tuple(1, 2.5, true, 'c')) == "(1,2.5,true,c)");
+  REQUIRE(lee::to_log(std::optional<int>(5)) == "5");
+  REQUIRE(lee::to_log(std::optional<int>()) == "none");
+  REQUIRE(lee::to_log(std::vector<std::vector<int>>{{1}, {}, {2, 3}}) ==
+          "[[1],[],[2,3]]");
+  REQUIRE(lee::to_log(std::string("plain")) == "plain");
+}
+
+TEST_CASE("to_log range limits", "[my_log][format_range]") {
+  std::vector<int> big(100000, 1);
+  REQUIRE(lee::to_log(big).size() < 300);
+  REQUIRE(lee::to_log(big).find(",1,... +99900 more]") != std::string::npos);
+
+  lee::range_limits limits;
+  limits.max_elements = 3;
+  limits.max_depth = 2;
+  std::string out;
+  lee::format_value(out, std::vector<int>{1, 2, 3, 4, 5}, limits);
+  REQUIRE(out == "[1,2,3,... +2 more]");
+  out.clear();
+  lee::format_value(out, std::forward_list<int>{1, 2, 3, 4}, limits);
+  REQUIRE(out == "[1,2,3,... +1 more]");
+  out.clear();
+  lee::format_value(out, std::vector<std::vector<std::vector<int>>>{{{1}}},
+                    limits);
+  REQUIRE(out == "[[[...]]]");
+  limits.max_elements = 0;
+  out.clear();
+  lee::format_value(out, std::vector<int>{1, 2}, limits);
+  REQUIRE(out == "[... +2 more]");
+
+  lee::set_range_limits(limits);
+  REQUIRE(lee::get_range_limits().max_elements == 0);
+  lee::set_range_limits(lee::range_limits());
+  REQUIRE(lee::get_range_limits().max_elements ==
+          lee::DEFAULT_RANGE_MAX_ELEMENTS);
+}
+
+TEST_CASE("log_stream containers", "[my_log][format_range]") {
+  LEE_LOG_SITE(site, lee::level_enum::off);
+  lee::log_stream stream(site);
+  stream << std::vector<int>{1, 2} << " " << std::make_pair(1, 2);
+  REQUIRE(stream.str() == "[1,2] (1,2)");
+  LOG(INFO) << "container " << std::map<int, int>{{1, 2}};
+}
+
+TEST_CASE("to_log container benchmark", "[my_log][format_range]") {
+  std::vector<int> values(100);
+  for (int i = 0; i < 100; ++i) {
+    values[i] = i * 1000;
+  }
+  std::size_t total = 0;
+  {
+    PROFILER_F();
+    for (int i = 0; i < 10000; ++i) {
+      total += lee::to_log(values).size();
+    }
+  }
+  REQUIRE(total > 0);
+}
@@ -0,0 +1,110 @@
+/// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
+///
+/// Use of this source code is governed by a MIT license
+/// that can be found in the License file.
+
+#include "my_log/format_string.hpp"
+
+#include <catch2/catch.hpp>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "log_wrapper.hpp"
+#include "profiler.hpp"
+
+namespace {
+template <typename... Args>
+constexpr lee::format_error check(std::string_view fmt, const Args&...) {
+  return lee::log::detail::format_checker<
+      lee::type_list<const char*, std::decay_t<Args>...>>::check(fmt);
+}
+
+template <typename... Args>
+std::string format(std::string_view fmt, const Args&... args) {
+  std::string out;
+  lee::format_to(out, fmt, args...);
+  return out;
+}
+
+struct no_output {};
+}  // namespace
+
+TEST_CASE("format string compile time check", "[my_log][format_string]") {
+  static_assert(check("{} took {}ms", 1, 2.5) == lee::format_error::none, "");
+  static_assert(check("{} took {}ms", 1) == lee::format_error::too_few_args,
+                "");
+  static_assert(check("{}", 1, 2) == lee::format_error::too_many_args, "");
+  static_assert(check("{{}} {}", 1) == lee::format_error::none, "");
+  static_assert(check("{", 1) == lee::format_error::unmatched_brace, "");
+  static_assert(check("}", 1) == lee::format_error::unmatched_brace, "");
+  static_assert(check("{:q}", 1) == lee::format_error::bad_spec, "");
+  static_assert(check("{:x}", 1.5) == lee::format_error::hex_needs_integer, "");
+  static_assert(check("{:x}", "text") == lee::format_error::hex_needs_integer,
+                "");
+  static_assert(check("{:.2f}", 3) == lee::format_error::precision_needs_float,
+                "");
+  static_assert(check("{}", no_output()) ==
+                    lee::format_error::unformattable_arg,
+                "");
+  static_assert(check("{:x} {:.3}", 255u, 1.0f) == lee::format_error::none,
+                "");
+  LEE_CHECK_FORMAT("{} and {}", 1, std::string("two"));
+}
+
+TEST_CASE("format_to", "[my_log][format_string]") {
+  REQUIRE(format("{} took {}ms", "query", 42) == "query took 42ms");
+  REQUIRE(format("{:x}", 255) == "0xff");
+  REQUIRE(format("{:x}", -1) == "0xffffffff");
+  REQUIRE(format("{:.2f}", 3.14159) == "3.14");
+  REQUIRE(format("{:.0}", 2.5) == "2");
+  REQUIRE(format("{}", 0.1) == "0.1");
+  REQUIRE(format("{{{}}}", 7) == "{7}");
+  REQUIRE(format("{} {} {}", true, 'c', std::string("s")) == "true c s");
+  REQUIRE(format("{}", std::vector<int>{1, 2, 3}) == "[1,2,3]");
+  REQUIRE(format("{}", std::map<int, int>{{1, 2}}) == "{1:2}");
+  REQUIRE(format("no args") == "no args");
+  const char* null_str = nullptr;
+  REQUIRE(format("[{}]", null_str) == "[(null)]");
+}
+
+TEST_CASE("LOG_*_FMT", "[my_log][format_string]") {
+  auto& wrapper = lee::log_wrapper::get_instance();
+  int evaluated = 0;
+  auto expensive = [&evaluated]() { return ++evaluated; };
+
+  wrapper.set_file_log_level(lee::level_enum::info);
+  wrapper.set_console_log_level(lee::level_enum::warn);
+  LOG_DEBUG_FMT("skipped {}", expensive());
+  REQUIRE(evaluated == 0);
+  LOG_INFO_FMT("{} took {}ms", "format string test", expensive());
+  REQUIRE(evaluated == 1);
+  wrapper.set_file_log_level(lee::DEFAULT_FILE_LOG_LEVEL);
+  wrapper.set_console_log_level(lee::DEFAULT_COUT_LOG_LEVEL);
+
+  LOG_TRACE_FMT("trace {}", 1);
+  LOG_WARN_FMT("warn {:x}", 0xbeef);
+  LOG_ERROR_FMT("error {:.3f}", 1.0 / 3);
+  LOG_CRITICAL_FMT("critical {}", std::vector<int>{1, 2});
+}
+
+TEST_CASE("format_to benchmark", "[my_log][format_string]") {
+  std::size_t total = 0;
+  {
+    PROFILER_F();
+    for (int i = 0; i < 100000; ++i) {
+      std::string out;
+      lee::format_to(out, "request {} took {}ms", i, i * 0.5);
+      total += out.size();
+    }
+  }
+  {
+    PROFILER_F();
+    for (int i = 0; i < 100000; ++i) {
+      std::string out = "request " + std::to_string(i) + " took " +
+                        std::to_string(i * 0.5) + "ms";
+      total += out.size();
+    }
+  }
+  REQUIRE(total > 0);
+}
@@ -1,4 +1,4 @@
-/// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
+﻿/// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
 ///
 /// Use of this source code is governed by a MIT license
 /// that can be found in the License file.
@@ -6,9 +6,36 @@
 #include "my_log/lazy_string.hpp"
 
 #include <catch2/catch.hpp>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
 
+#include "log_wrapper.hpp"
 #include "profiler.hpp"
 
+namespace {
+/// 记下最后一条日志的内容
+class payload_sink final : public lee::sink {
+ public:
+  void log(const lee::log_record& record) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    last_.assign(record.payload.data(), record.payload.size());
+  }
+  void flush() override {}
+
+  std::string last() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return last_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::string last_;
+};
+}  // namespace
+
 TEST_CASE("lazy_string", "[my_log][lazy_string]") {
   {
     PROFILER_F();
@@ -38,3 +65,127 @@ TEST_CASE("string", "[my_log][lazy_string]") {
     }
   }
 }
+
+TEST_CASE("lazy_string pieces", "[my_log][lazy_string]") {
+  const lee::lazy_string_concat_helper<> lazy_concat;
+  const std::string name = "query";
+  const std::string_view unit = "ms";
+  const char* null_str = nullptr;
+  std::string result = lazy_concat + name + " took " + 42 + unit + ' ' +
+                       -7 + " " + 0.5 + " " + true + " " + null_str;
+  REQUIRE(result == "query took 42ms -7 0.5 true (null)");
+
+  static_assert(
+      std::is_same<decltype((lazy_concat + name).size()), std::size_t>::value,
+      "size must be size_t");
+  REQUIRE((lazy_concat + name + 12345u).size() == 10);
+  REQUIRE(std::string(lazy_concat) == "");
+}
+
+TEST_CASE("lazy_string benchmark", "[my_log][lazy_string]") {
+  const std::string file = "lksjdflksdjflkdsjlkdsfjldskfjsdlkfjslkdfjlksddjfsl";
+  /// 两段循环用同一个行号, 拼出的长度才相同
+  const int line = __LINE__;
+  std::size_t lazy_total = 0;
+  std::size_t plain_total = 0;
+  {
+    PROFILER_F();
+    for (int i = 0; i < 100000; ++i) {
+      const lee::lazy_string_concat_helper<> lazy_concat;
+      std::string str_log = lazy_concat + "request " + i + " <In Function: " +
+                            __func__ + ", File: " + file + " Line: " +
+                            line + ", PID: " + __FILE__ + ">";
+      lazy_total += str_log.size();
+    }
+  }
+  {
+    PROFILER_F();
+    for (int i = 0; i < 100000; ++i) {
+      std::string plain;
+      std::string str_log = plain + "request " + std::to_string(i) +
+                            " <In Function: " + __func__ + ", File: " + file +
+                            " Line: " + std::to_string(line) +
+                            ", PID: " + __FILE__ + ">";
+      plain_total += str_log.size();
+    }
+  }
+  REQUIRE(lazy_total == plain_total);
+}
+
+TEST_CASE("log macros evaluate the argument as one expression",
+          "[my_log][lazy_string]") {
+  auto sink = std::make_shared<payload_sink>();
+  lee::log_wrapper::get_instance().add_sink(sink);
+  auto& named = LEE_LOGGER("lazy_string.expression");
+  named.add_sink(sink);
+
+  const bool ok = true;
+  const int a = 3;
+  const int b = 4;
+  const std::string name = "query";
+  LOG_WARN(ok ? "yes" : "no");
+  REQUIRE(sink->last() == "yes");
+  LOG_WARN(a == b);
+  REQUIRE(sink->last() == "false");
+  LOG_WARN(a | b);
+  REQUIRE(sink->last() == "7");
+  LOG_WARN(a << 1);
+  REQUIRE(sink->last() == "6");
+  LOG_WARN(name + " done");
+  REQUIRE(sink->last() == "query done");
+  LOG_WARN(lee::lazy_concat() + name + " took " + 42 + "ms");
+  REQUIRE(sink->last() == "query took 42ms");
+
+  LOG_WARN(name, " took ", 42, "ms");
+  REQUIRE(sink->last() == "query took 42ms");
+  LOG_WARN("sum ", a + b, ' ', a == b, ' ', 1.5);
+  REQUIRE(sink->last() == "sum 7 false 1.5");
+
+  LOGGER_WARN(named, !ok ? "yes" : "no");
+  REQUIRE(sink->last() == "no");
+  LOGGER_WARN(named, a < b);
+  REQUIRE(sink->last() == "true");
+  LOGGER_WARN(named, name, ": ", a << 1, "/", b);
+  REQUIRE(sink->last() == "query: 6/4");
+
+  REQUIRE(named.remove_sink(sink));
+  REQUIRE(lee::log_wrapper::get_instance().remove_sink(sink));
+}
+
+TEST_CASE("lazy_concat arguments", "[my_log][lazy_string]") {
+  const std::string name = "query";
+  const char* missing = nullptr;
+  REQUIRE(std::string(lee::lazy_concat(name, " took ", 42u, "ms")) ==
+          "query took 42ms");
+  REQUIRE(lee::lazy_concat(name, 12345).size() == 10);
+  REQUIRE(std::string(lee::lazy_concat(missing, '!')) == "(null)!");
+  REQUIRE(std::string(lee::lazy_concat(std::string_view("view"))) == "view");
+}
+
+TEST_CASE("log macro benchmark", "[my_log][lazy_string]") {
+  auto sink = std::make_shared<payload_sink>();
+  auto& named = LEE_LOGGER("lazy_string.benchmark");
+  named.add_sink(sink);
+  const std::string file = "lksjdflksdjflkdsjlkdsfjldskfjsdlkfjslkdfjlksddjfsl";
+  const int line = __LINE__;
+  {
+    /// 一个参数: 先拼出 std::string 再交给宏
+    PROFILER_F();
+    for (int i = 0; i < 100000; ++i) {
+      LOGGER_INFO(named, "request " + std::to_string(i) + " <In Function: " +
+                             __func__ + ", File: " + file +
+                             " Line: " + std::to_string(line) + ">");
+    }
+  }
+  const std::string single = sink->last();
+  {
+    /// 多个参数: 每段直接写进栈上的缓冲区
+    PROFILER_F();
+    for (int i = 0; i < 100000; ++i) {
+      LOGGER_INFO(named, "request ", i, " <In Function: ", __func__,
+                  ", File: ", file, " Line: ", line, ">");
+    }
+  }
+  REQUIRE(sink->last() == single);
+  REQUIRE(named.remove_sink(sink));
+}
@@ -0,0 +1,72 @@
+/// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
+///
+/// Use of this source code is governed by a MIT license
+/// that can be found in the License file.
+
+/// 本文件只编译 info 及以上等级的日志
+#define LEE_LOG_ACTIVE_LEVEL LEE_LOG_LEVEL_INFO
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "log_stream.hpp"
+#include "log_wrapper.hpp"
+#include "my_log/binary_log.hpp"
+
+namespace {
+int evaluated_count = 0;
+
+/// 标记串的地址写入 volatile 变量, 编译器必须把整个字面量放进可执行文件,
+/// 不能在优化时把它拆成立即数直接写进 std::string
+const char* volatile last_marker = nullptr;
+
+[[gnu::noinline]] std::string expensive(const char* marker) {
+  ++evaluated_count;
+  last_marker = marker;
+  return marker;
+}
+
+/// 标记串倒序存放, 避免查找用的字符串本身出现在可执行文件里
+bool binary_contains(std::string reversed_marker) {
+  std::reverse(reversed_marker.begin(), reversed_marker.end());
+  std::ifstream ifs("/proc/self/exe", std::ifstream::binary);
+  std::string image((std::istreambuf_iterator<char>(ifs)),
+                    std::istreambuf_iterator<char>());
+  return image.find(reversed_marker) != std::string::npos;
+}
+}  // namespace
+
+TEST_CASE("LEE_LOG_ACTIVE_LEVEL skips disabled levels",
+          "[my_log][log_level]") {
+  evaluated_count = 0;
+  LOG_TRACE(expensive("lee_compiled_out_trace_marker"));
+  LOG_DEBUG(expensive("lee_compiled_out_debug_marker"));
+  LOG(TRACE) << expensive("lee_compiled_out_stream_trace_marker");
+  LOG(DEBUG) << expensive("lee_compiled_out_stream_debug_marker");
+  LOG_BINARY(debug, "lee_compiled_out_binary_marker {}",
+             expensive("lee_compiled_out_binary_arg"));
+  REQUIRE(evaluated_count == 0);
+
+  LOG_INFO(expensive("lee_compiled_in_info_marker"));
+  LOG(WARN) << expensive("lee_compiled_in_stream_warn_marker");
+  REQUIRE(evaluated_count == 2);
+}
+
+#ifdef __linux__
+TEST_CASE("LEE_LOG_ACTIVE_LEVEL leaves no trace in the binary",
+          "[my_log][log_level]") {
+  /// 启用的标记串一定在, 下面找不到被编译掉的标记串才有意义
+  REQUIRE(binary_contains("rekram_ofni_ni_delipmoc_eel"));
+  REQUIRE(binary_contains("rekram_nraw_maerts_ni_delipmoc_eel"));
+
+  REQUIRE_FALSE(binary_contains("rekram_ecart_tuo_delipmoc_eel"));
+  REQUIRE_FALSE(binary_contains("rekram_gubed_tuo_delipmoc_eel"));
+  REQUIRE_FALSE(binary_contains("rekram_ecart_maerts_tuo_delipmoc_eel"));
+  REQUIRE_FALSE(binary_contains("rekram_gubed_maerts_tuo_delipmoc_eel"));
+  REQUIRE_FALSE(binary_contains("rekram_yranib_tuo_delipmoc_eel"));
+  REQUIRE_FALSE(binary_contains("gra_yranib_tuo_delipmoc_eel"));
+}
+#endif
@@ -6,6 +6,11 @@
 #include "log_stream.hpp"
 
 #include <catch2/catch.hpp>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 
 #include "profiler.hpp"
 
@@ -52,3 +57,63 @@ TEST_CASE("log_stream 特殊值测试", "log3") {
   LOG(ERROR) << ("string");
   LOG(CRITICAL) << ("string");
 }
+
+TEST_CASE("log_stream 与 if/else 连用", "[my_log][log_stream]") {
+  bool else_branch = false;
+  if (else_branch)
+    LOG(INFO) << "never";
+  else
+    else_branch = true;
+  REQUIRE(else_branch);
+  LOG(OFF) << "off is never written";
+}
+
+namespace {
+struct point {
+  int x;
+  int y;
+};
+
+std::ostream& operator<<(std::ostream& os, const point& p) {
+  return os << "(" << p.x << ", " << p.y << ")";
+}
+}  // namespace
+
+TEST_CASE("log_stream 格式", "[my_log][log_stream]") {
+  LEE_LOG_SITE(site, lee::level_enum::off);
+  auto format = [](auto&&... args) {
+    lee::log_stream stream(site);
+    (stream << ... << args);
+    std::ostringstream expected;
+    (expected << ... << args);
+    return std::make_pair(stream.str(), expected.str());
+  };
+  std::string text = "text";
+  std::string_view view = "view";
+  const char* null_str = nullptr;
+  auto result = format("a", 1, " ", ' ', -42LL, text, view, 'c',
+                       18446744073709551615ULL, point{1, 2});
+  REQUIRE(result.first == result.second);
+  /// 浮点数输出最短往返表示
+  REQUIRE(format(2.0, " ", 3.14159265, " ", 1e20, " ", 0.1f).first ==
+          "2 3.14159265 1e+20 0.1");
+  REQUIRE(format(true, false).first == "truefalse");
+  REQUIRE(format(null_str).first == "(null)");
+
+  std::string big(1000, 'x');
+  auto big_result = format(big, 1, big);
+  REQUIRE(big_result.first == big_result.second);
+}
+
+TEST_CASE("log_stream 只能移动", "[my_log][log_stream]") {
+  static_assert(!std::is_copy_constructible<lee::log_stream>::value,
+                "log_stream must not be copyable");
+  static_assert(std::is_move_constructible<lee::log_stream>::value,
+                "log_stream must be movable");
+  LEE_LOG_SITE(site, lee::level_enum::off);
+  lee::log_stream from(site);
+  from << "moved";
+  lee::log_stream to(std::move(from));
+  REQUIRE(from.str().empty());
+  REQUIRE(to.str() == "moved");
+}
@@ -6,7 +6,17 @@
 #include "log_wrapper.hpp"
 
 #include <catch2/catch.hpp>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
 
+#if defined(__unix__)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "log_stream.hpp"
 #include "profiler.hpp"
 
 TEST_CASE("log_wrapper", "log") {
@@ -30,3 +40,89 @@ TEST_CASE("log_wrapper2", "log2") {
     }
   }
 }
+
+TEST_CASE("log_site", "[my_log][log_site]") {
+  static_assert(std::string::traits_type::compare(
+                    lee::file_basename("/a/b/c.cc"), "c.cc", 5) == 0,
+                "file_basename must run at compile time");
+  static_assert(lee::make_site_id("a.cc", 1) != lee::make_site_id("a.cc", 2),
+                "site id must depend on the line");
+  REQUIRE(std::string(lee::file_basename("c.cc")) == "c.cc");
+  REQUIRE(std::string(lee::file_basename("dir/")) == "");
+  REQUIRE(std::string(LEE_FILE_BASENAME) == "log_wrapper_unittest.cc");
+
+  LEE_LOG_SITE(site, lee::level_enum::warn);
+  REQUIRE(std::string(site.file) == "log_wrapper_unittest.cc");
+  REQUIRE(std::string(site.func) == __func__);
+  REQUIRE(site.line == __LINE__ - 3);
+  REQUIRE(site.level == lee::level_enum::warn);
+}
+
+TEST_CASE("log_wrapper runtime level gate", "[my_log][log_wrapper]") {
+  auto& wrapper = lee::log_wrapper::get_instance();
+  int evaluated = 0;
+  auto expensive = [&evaluated]() {
+    ++evaluated;
+    return std::string("expensive");
+  };
+
+  wrapper.set_file_log_level(lee::level_enum::info);
+  wrapper.set_console_log_level(lee::level_enum::warn);
+  REQUIRE(lee::log_wrapper::min_level() == lee::level_enum::info);
+  LOG_DEBUG(expensive());
+  LOG(DEBUG) << expensive();
+  REQUIRE(evaluated == 0);
+  LOG_INFO(expensive());
+  LOG(INFO) << expensive();
+  REQUIRE(evaluated == 2);
+
+  wrapper.set_file_log_level(lee::DEFAULT_FILE_LOG_LEVEL);
+  wrapper.set_console_log_level(lee::DEFAULT_COUT_LOG_LEVEL);
+  REQUIRE(lee::log_wrapper::min_level() == lee::level_enum::debug);
+}
+
+TEST_CASE("thread identity", "[my_log][log_wrapper]") {
+  const auto& main_identity = lee::current_thread_identity();
+  REQUIRE(main_identity.tid == lee::thread_id());
+  REQUIRE(main_identity.process_id == lee::pid());
+  REQUIRE(&main_identity == &lee::current_thread_identity());
+
+  std::string rendered;
+  size_t tid = 0;
+  std::thread worker([&rendered, &tid] {
+    lee::set_thread_name("io-3");
+    tid = lee::thread_id();
+    rendered = lee::current_thread_identity().rendered;
+    LOG_INFO("named thread record");
+  });
+  worker.join();
+  REQUIRE(tid != main_identity.tid);
+  REQUIRE(rendered == "PID: " + std::to_string(lee::pid()) +
+                          ", TID: " + std::to_string(tid) + ", Thread: io-3");
+  REQUIRE(main_identity.name.empty());
+}
+
+#if defined(__unix__)
+TEST_CASE("file double buffer is flushed at exit", "[my_log][log_wrapper]") {
+  const std::string marker = "double buffer exit marker " +
+                             std::to_string(lee::pid());
+  /// 子进程开启双缓冲后直接退出, 单例不析构, 只有 atexit 会写完缓冲区
+  const pid_t child = ::fork();
+  REQUIRE(child >= 0);
+  if (child == 0) {
+    auto& wrapper = lee::log_wrapper::get_instance();
+    wrapper.enable_file_double_buffer(1024 * 1024, std::chrono::seconds(10));
+    LOG_DEBUG(marker);
+    std::exit(0);
+  }
+  int status = 0;
+  REQUIRE(::waitpid(child, &status, 0) == child);
+  REQUIRE(WIFEXITED(status));
+  REQUIRE(WEXITSTATUS(status) == 0);
+
+  std::ifstream ifs("log/detail/detail_log.log", std::ifstream::binary);
+  std::ostringstream oss;
+  oss << ifs.rdbuf();
+  REQUIRE(oss.str().find(marker) != std::string::npos);
+}
+#endif
@@ -0,0 +1,155 @@
+/// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
+///
+/// Use of this source code is governed by a MIT license
+/// that can be found in the License file.
+
+#include "my_log/memory_pool.hpp"
+
+#include <array>
+#include <catch2/catch.hpp>
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "log_stream.hpp"
+#include "log_wrapper.hpp"
+#include "my_log/small_buffer.hpp"
+
+namespace {
+/// 记录经过它的申请次数
+class counting_resource : public std::pmr::memory_resource {
+ public:
+  std::size_t allocations = 0;
+
+ private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    ++allocations;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+  void do_deallocate(void* p, std::size_t bytes,
+                     std::size_t alignment) override {
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+  bool do_is_equal(const std::pmr::memory_resource& other) const
+      noexcept override {
+    return this == &other;
+  }
+};
+}  // namespace
+
+TEST_CASE("thread_pool_resource recycles blocks", "[my_log][memory_pool]") {
+  auto& pool = lee::thread_pool_resource::this_thread();
+  REQUIRE(&pool == &lee::thread_pool_resource::this_thread());
+  const auto before = pool.stats();
+
+  void* first = pool.allocate(100);
+  pool.deallocate(first, 100);
+  void* second = pool.allocate(200);
+  REQUIRE(second == first);  ///< 同一档的块被复用
+  pool.deallocate(second, 200);
+
+  const auto after = pool.stats();
+  REQUIRE(after.allocations == before.allocations + 2);
+  REQUIRE(after.spills == before.spills);
+  REQUIRE(after.in_use == before.in_use);
+  REQUIRE(after.high_water >= 256);
+}
+
+TEST_CASE("thread_pool_resource spills", "[my_log][memory_pool]") {
+  auto& pool = lee::thread_pool_resource::this_thread();
+  const auto before = pool.stats();
+
+  void* large = pool.allocate(lee::POOL_BLOCK_SIZES[3] + 1);
+  REQUIRE(pool.stats().spills == before.spills + 1);
+  pool.deallocate(large, lee::POOL_BLOCK_SIZES[3] + 1);
+
+  /// 把一档用完, 多出来的一次交给上游
+  std::vector<void*> blocks;
+  for (std::size_t i = 0; i <= lee::DEFAULT_POOL_BLOCKS_PER_CLASS; ++i) {
+    blocks.push_back(pool.allocate(64));
+  }
+  REQUIRE(pool.stats().spills >= before.spills + 2);
+  REQUIRE(pool.stats().high_water >=
+          lee::DEFAULT_POOL_BLOCKS_PER_CLASS * lee::POOL_BLOCK_SIZES[0]);
+  for (auto* p : blocks) {
+    pool.deallocate(p, 64);
+  }
+  REQUIRE(pool.stats().in_use == before.in_use);
+}
+
+TEST_CASE("thread_pool_resource remote free", "[my_log][memory_pool]") {
+  auto& pool = lee::thread_pool_resource::this_thread();
+  const auto before = pool.stats();
+  void* block = pool.allocate(1000);
+  std::thread other([&pool, block] { pool.deallocate(block, 1000); });
+  other.join();
+  REQUIRE(pool.stats().in_use == before.in_use);
+
+  /// 其他线程还回来的块在本线程空闲链表用完后取回, 不会交给上游
+  std::vector<void*> blocks;
+  bool reused = false;
+  for (std::size_t i = 0; i < lee::DEFAULT_POOL_BLOCKS_PER_CLASS; ++i) {
+    blocks.push_back(pool.allocate(1000));
+    reused = reused || blocks.back() == block;
+  }
+  REQUIRE(reused);
+  REQUIRE(pool.stats().spills == before.spills);
+  for (auto* p : blocks) {
+    pool.deallocate(p, 1000);
+  }
+
+  /// 线程退出后, 它的内存池里没有释放的块仍可在别的线程释放
+  std::pmr::string* leftover = nullptr;
+  std::thread owner([&leftover] {
+    leftover = new std::pmr::string(300, 'x',
+                                    &lee::thread_pool_resource::this_thread());
+  });
+  owner.join();
+  REQUIRE(leftover->size() == 300);
+  delete leftover;
+}
+
+TEST_CASE("log buffers take a memory_resource", "[my_log][memory_pool]") {
+  counting_resource counting;
+  {
+    lee::small_buffer<16> buffer(&counting);
+    buffer.append(std::string(15, 'a'));
+    REQUIRE(counting.allocations == 0);
+    buffer.append(std::string(2, 'b'));
+    REQUIRE(buffer.spilled());
+    REQUIRE(counting.allocations == 1);
+    lee::small_buffer<16> moved(std::move(buffer));
+    REQUIRE(moved.view() == std::string(15, 'a') + "bb");
+  }
+
+  {
+    LEE_LOG_SITE(site, lee::level_enum::trace);
+    lee::log_stream stream(site, &counting);
+    stream << std::string(lee::DEFAULT_INLINE_BUFFER_SIZE + 1, 'c');
+    REQUIRE(counting.allocations == 2);
+  }
+
+  const auto text = lee::to_log(std::vector<int>{1, 2, 3}, &counting);
+  REQUIRE(text == "[1,2,3]");
+  REQUIRE(text.get_allocator().resource() == &counting);
+  REQUIRE(lee::to_log(42, &counting) == "42");
+  REQUIRE(lee::to_log("text", &counting) == "text");
+}
+
+TEST_CASE("scoped_log_resource", "[my_log][memory_pool]") {
+  REQUIRE(lee::current_log_resource() ==
+          &lee::thread_pool_resource::this_thread());
+
+  std::array<std::byte, 4096> storage;
+  std::pmr::monotonic_buffer_resource arena(storage.data(), storage.size(),
+                                            std::pmr::null_memory_resource());
+  {
+    lee::scoped_log_resource scope(&arena);
+    REQUIRE(lee::current_log_resource() == &arena);
+    LOG(TRACE) << std::string(lee::DEFAULT_INLINE_BUFFER_SIZE * 2, 'a');
+  }
+  REQUIRE(lee::current_log_resource() ==
+          &lee::thread_pool_resource::this_thread());
+}
@@ -0,0 +1,175 @@
+/// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
+///
+/// Use of this source code is governed by a MIT license
+/// that can be found in the License file.
+
+/// 本文件中的日志调用点都属于该模块
+#define LEE_LOG_MODULE "test.module"
+
+#include "my_log/module_level.hpp"
+
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "log_stream.hpp"
+#include "log_wrapper.hpp"
+
+TEST_CASE("module levels resolve from the most specific rule",
+          "[my_log][module_level]") {
+  auto& levels = lee::module_levels::get_instance();
+  levels.clear();
+  REQUIRE(levels.effective_level("net.tcp", "a.cc") == lee::level_enum::trace);
+
+  levels.set_level("net", lee::level_enum::debug);
+  levels.set_level("net.tcp", lee::level_enum::warn);
+  REQUIRE(levels.effective_level("net.tcp.conn", "a.cc") ==
+          lee::level_enum::warn);
+  REQUIRE(levels.effective_level("net.udp", "a.cc") == lee::level_enum::debug);
+  REQUIRE(levels.effective_level("net", "a.cc") == lee::level_enum::debug);
+  /// 按 '.' 分层, 不是字符串前缀
+  REQUIRE(levels.effective_level("network", "a.cc") == lee::level_enum::trace);
+
+  levels.set_file_level("net_", lee::level_enum::error);
+  REQUIRE(levels.effective_level("", "net_server.cc") == lee::level_enum::error);
+  REQUIRE(levels.effective_level("net.udp", "net_server.cc") ==
+          lee::level_enum::debug);
+  levels.set_file_level("net_server", lee::level_enum::critical);
+  REQUIRE(levels.effective_level("", "net_server.cc") ==
+          lee::level_enum::critical);
+
+  levels.set_level("", lee::level_enum::info);
+  REQUIRE(levels.effective_level("db", "db.cc") == lee::level_enum::info);
+  REQUIRE(levels.effective_level("", "net_client.cc") == lee::level_enum::error);
+
+  REQUIRE(levels.clear_level("net.tcp"));
+  REQUIRE_FALSE(levels.clear_level("net.tcp"));
+  REQUIRE(levels.effective_level("net.tcp.conn", "a.cc") ==
+          lee::level_enum::debug);
+  REQUIRE(levels.clear_file_level("net_"));
+  REQUIRE(levels.effective_level("", "net_client.cc") == lee::level_enum::info);
+
+  levels.clear();
+  REQUIRE(levels.effective_level("net", "net_server.cc") ==
+          lee::level_enum::trace);
+}
+
+TEST_CASE("module_site resolves again only after the generation changes",
+          "[my_log][module_level]") {
+  auto& levels = lee::module_levels::get_instance();
+  levels.clear();
+  static lee::module_site site{"cache.test", "cache.cc"};
+  int resolves = 0;
+  auto resolve = [&resolves](std::string_view module, std::string_view file) {
+    ++resolves;
+    return lee::module_levels::get_instance().effective_level(module, file);
+  };
+
+  int passed = 0;
+  for (int i = 0; i < 1000; ++i) {
+    passed += site.should_log(lee::level_enum::debug, resolve) ? 1 : 0;
+  }
+  REQUIRE(passed == 1000);
+  REQUIRE(resolves == 1);
+
+  levels.set_level("cache", lee::level_enum::warn);
+  REQUIRE_FALSE(site.should_log(lee::level_enum::debug, resolve));
+  REQUIRE(site.should_log(lee::level_enum::warn, resolve));
+  REQUIRE(resolves == 2);
+
+  /// 其他等级的变化同样让缓存过期
+  lee::module_levels::invalidate();
+  REQUIRE(site.should_log(lee::level_enum::error));
+  REQUIRE(resolves == 2);
+  levels.clear();
+  REQUIRE(site.should_log(lee::level_enum::debug));
+}
+
+TEST_CASE("log macros honour the call site's module level",
+          "[my_log][module_level]") {
+  auto& levels = lee::module_levels::get_instance();
+  auto& wrapper = lee::log_wrapper::get_instance();
+  auto attached = std::make_shared<lee::counting_sink<std::mutex>>();
+  wrapper.add_sink(attached);
+  levels.clear();
+
+  /// 根模块只要 warn, 本模块单独打开 debug
+  levels.set_level("", lee::level_enum::warn);
+  levels.set_level("test", lee::level_enum::debug);
+  LOG_DEBUG("module debug enabled");
+  LOG_TRACE("module trace still filtered");
+  REQUIRE(attached->total() == 1);
+
+  levels.set_level("test.module", lee::level_enum::error);
+  int evaluated = 0;
+  LOG_WARN_FMT("filtered {}", ++evaluated);
+  LOG(lee::level_enum::warn) << ++evaluated;
+  LOG_ERROR(lee::lazy_concat() + "module error " + 1);
+  REQUIRE(evaluated == 0);
+  REQUIRE(attached->total() == 2);
+  REQUIRE(attached->count(lee::level_enum::error) == 1);
+
+  /// 输出的等级仍然生效
+  levels.clear();
+  attached->set_level(lee::level_enum::critical);
+  wrapper.refresh_sink_levels();
+  LOG_TRACE("filtered by every sink");
+  REQUIRE(attached->total() == 2);
+  REQUIRE(wrapper.remove_sink(attached));
+}
+
+TEST_CASE("named logger macros honour the call site's module level",
+          "[my_log][module_level]") {
+  auto& levels = lee::module_levels::get_instance();
+  auto& named = LEE_LOGGER("module_level.named");
+  auto attached = std::make_shared<lee::counting_sink<std::mutex>>();
+  named.add_sink(attached);
+  levels.clear();
+
+  levels.set_level("test.module", lee::level_enum::error);
+  int evaluated = 0;
+  LOGGER_WARN(named, ++evaluated);
+  LOGGER_WARN_FMT(named, "filtered {}", ++evaluated);
+  LOGGER_ERROR_FMT(named, "module error {}", 1);
+  REQUIRE(evaluated == 0);
+  REQUIRE(attached->total() == 1);
+
+  levels.clear();
+  LOGGER_WARN(named, "module rule cleared");
+  REQUIRE(attached->total() == 2);
+  REQUIRE(named.remove_sink(attached));
+}
+
+TEST_CASE("module level check cost with many rules", "[my_log][module_level]") {
+  constexpr int ITERATIONS = 10000000;
+  constexpr int RULES = 5000;
+  auto& levels = lee::module_levels::get_instance();
+  levels.clear();
+  levels.set_level("", lee::level_enum::warn);
+
+  auto measure = [] {
+    int evaluated = 0;
+    const auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; ++i) {
+      LOG_DEBUG(++evaluated);
+    }
+    const auto end = std::chrono::steady_clock::now();
+    REQUIRE(evaluated == 0);
+    return std::chrono::duration<double, std::nano>(end - begin).count() /
+           ITERATIONS;
+  };
+
+  const auto few = measure();
+  for (int i = 0; i < RULES; ++i) {
+    levels.set_level("bench.module" + std::to_string(i), lee::level_enum::trace);
+    levels.set_file_level("bench_file" + std::to_string(i),
+                          lee::level_enum::trace);
+  }
+  const auto many = measure();
+  levels.clear();
+  std::cout << "filtered LOG_DEBUG with 1 rule: " << few << " ns/call, with "
+            << 2 * RULES << " rules: " << many << " ns/call" << std::endl;
+}
@@ -0,0 +1,123 @@
+/// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
+///
+/// Use of this source code is governed by a MIT license
+/// that can be found in the License file.
+
+#include "my_log/mutex.hpp"
+
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "log_wrapper.hpp"
+
+namespace {
+template <typename Mutex>
+std::size_t count_under_lock(int threads, int per_thread) {
+  Mutex mutex;
+  std::size_t counter = 0;
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&mutex, &counter, per_thread] {
+      for (int i = 0; i < per_thread; ++i) {
+        std::lock_guard<Mutex> lock(mutex);
+        ++counter;
+      }
+    });
+  }
+  for (auto& it : workers) {
+    it.join();
+  }
+  return counter;
+}
+
+/// threads 个线程同时往一个 counting_sink 写, 返回每条日志的纳秒数
+template <typename Mutex>
+double contention_ns(int threads, int per_thread) {
+  lee::counting_sink<Mutex> sink;
+  LEE_LOG_SITE(site, lee::level_enum::info);
+  std::vector<std::thread> workers;
+  const auto begin = std::chrono::steady_clock::now();
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&sink, per_thread] {
+      lee::log_record record;
+      record.site = &site;
+      record.thread = &lee::current_thread_identity();
+      for (int i = 0; i < per_thread; ++i) {
+        sink.log(record);
+      }
+    });
+  }
+  for (auto& it : workers) {
+    it.join();
+  }
+  const auto end = std::chrono::steady_clock::now();
+  REQUIRE(sink.total() == static_cast<std::size_t>(threads) * per_thread);
+  return std::chrono::duration<double, std::nano>(end - begin).count() /
+         (static_cast<double>(threads) * per_thread);
+}
+}  // namespace
+
+TEST_CASE("mutex policies exclude each other", "[my_log][mutex]") {
+  REQUIRE(count_under_lock<lee::spin_mutex>(4, 20000) == 80000);
+  REQUIRE(count_under_lock<lee::adaptive_mutex>(4, 20000) == 80000);
+  REQUIRE(count_under_lock<lee::null_mutex>(1, 20000) == 20000);
+
+  lee::spin_mutex spin;
+  REQUIRE(spin.try_lock());
+  REQUIRE_FALSE(spin.try_lock());
+  spin.unlock();
+
+  lee::adaptive_mutex adaptive(0);
+  REQUIRE(adaptive.try_lock());
+  std::thread waiter([&adaptive] {
+    adaptive.lock();  ///< 不自旋, 直接挂起直到主线程解锁
+    adaptive.unlock();
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  adaptive.unlock();
+  waiter.join();
+  REQUIRE(adaptive.try_lock());
+  adaptive.unlock();
+}
+
+TEST_CASE("sink levels are atomic", "[my_log][mutex]") {
+  lee::counting_sink<lee::null_mutex> sink;
+  std::thread writer([&sink] {
+    for (int i = 0; i < 10000; ++i) {
+      sink.set_level(i % 2 == 0 ? lee::level_enum::info : lee::level_enum::warn);
+    }
+  });
+  std::size_t accepted = 0;
+  for (int i = 0; i < 10000; ++i) {
+    accepted += sink.should_log(lee::level_enum::warn) ? 1 : 0;
+  }
+  writer.join();
+  REQUIRE(accepted == 10000);
+  REQUIRE(sink.level() == lee::level_enum::warn);
+}
+
+TEST_CASE("mutex contention benchmark", "[my_log][mutex]") {
+  static_assert(std::is_same<lee::default_sink_mutex, std::mutex>::value,
+                "update the benchmark header together with the default");
+  constexpr int PER_THREAD = 200000;
+  /// 核数少于线程数时测到的是轮流调度, 不能据此选择有竞争时的锁
+  std::cout << "hardware threads: " << std::thread::hardware_concurrency()
+            << "\nthreads  default(std::mutex)  spin_mutex  adaptive_mutex "
+               "(ns/record, ratio to default)\n";
+  for (int threads : {1, 2, 4, 8}) {
+    const auto per_thread = PER_THREAD / threads;
+    const double base =
+        contention_ns<lee::default_sink_mutex>(threads, per_thread);
+    const double spin = contention_ns<lee::spin_mutex>(threads, per_thread);
+    const double adaptive =
+        contention_ns<lee::adaptive_mutex>(threads, per_thread);
+    std::cout << threads << "  " << base << "  " << spin << " ("
+              << spin / base << ")  " << adaptive << " (" << adaptive / base
+              << ")" << std::endl;
+  }
+}
@@ -0,0 +1,176 @@
+/// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
+///
+/// Use of this source code is governed by a MIT license
+/// that can be found in the License file.
+
+#include "my_log/registry.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "log_wrapper.hpp"
+
+namespace {
+/// 记下最后一条日志和刷新次数
+class capture_sink final : public lee::sink {
+ public:
+  void log(const lee::log_record& record) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    last_.assign(record.payload.data(), record.payload.size());
+    ++records_;
+  }
+  void flush() override { flushes_.fetch_add(1); }
+
+  std::string last() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return last_;
+  }
+  std::size_t records() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return records_;
+  }
+  std::size_t flushes() const { return flushes_.load(); }
+
+ private:
+  std::mutex mutex_;
+  std::string last_;
+  std::size_t records_ = 0;
+  std::atomic<std::size_t> flushes_{0};
+};
+
+lee::logger& cached_handle() { return LEE_LOGGER("registry.cached"); }
+}  // namespace
+
+TEST_CASE("logger_registry creates each name once", "[my_log][registry]") {
+  auto& registry = lee::logger_registry::get_instance();
+  REQUIRE(registry.find("registry.absent") == nullptr);
+
+  auto& first = registry.get("registry.once");
+  REQUIRE(&registry.get("registry.once") == &first);
+  REQUIRE(registry.find("registry.once") == &first);
+  REQUIRE(first.name() == "registry.once");
+
+  const auto names = registry.names();
+  REQUIRE(std::find(names.begin(), names.end(), "registry.once") !=
+          names.end());
+
+  /// 每个调用点只查找一次, 之后都是同一个对象
+  REQUIRE(&cached_handle() == &cached_handle());
+  REQUIRE(&cached_handle() == registry.find("registry.cached"));
+}
+
+TEST_CASE("named loggers keep their own sinks and levels",
+          "[my_log][registry]") {
+  auto& market = LEE_LOGGER("registry.market");
+  auto& control = LEE_LOGGER("registry.control");
+  auto market_sink = std::make_shared<capture_sink>();
+  auto control_sink = std::make_shared<capture_sink>();
+  market.add_sink(market_sink);
+  control.add_sink(control_sink);
+  control.set_level(lee::level_enum::warn);
+
+  /// 没有 sink 的 logger 过滤所有等级
+  REQUIRE_FALSE(LEE_LOGGER("registry.empty").should_log(lee::level_enum::critical));
+
+  const int px = 101;
+  LOGGER_INFO(market, lee::lazy_concat() + "px " + px);
+  LOGGER_INFO_FMT(control, "state {}", "ignored");
+  LOGGER_ERROR_FMT(control, "state {}", 3);
+  REQUIRE(market_sink->last() == "px 101");
+  REQUIRE(market_sink->records() == 1);
+  REQUIRE(control_sink->last() == "state 3");
+  REQUIRE(control_sink->records() == 1);
+
+  /// 等级的改变马上生效, 被过滤的参数不求值
+  market.set_level(lee::level_enum::error);
+  int evaluated = 0;
+  LOGGER_INFO(market, ++evaluated);
+  REQUIRE(evaluated == 0);
+  REQUIRE(market_sink->records() == 1);
+
+  /// sink 自己的等级也参与过滤
+  market.set_level(lee::level_enum::trace);
+  market_sink->set_level(lee::level_enum::critical);
+  market.refresh_sink_levels();
+  REQUIRE_FALSE(market.should_log(lee::level_enum::error));
+  REQUIRE(market.should_log(lee::level_enum::critical));
+
+  REQUIRE(market.remove_sink(market_sink));
+  REQUIRE(control.remove_sink(control_sink));
+  REQUIRE_FALSE(market.should_log(lee::level_enum::critical));
+}
+
+TEST_CASE("named logger flushes at its flush level", "[my_log][registry]") {
+  auto& flushing = LEE_LOGGER("registry.flush");
+  auto sink = std::make_shared<capture_sink>();
+  flushing.add_sink(sink);
+
+  LOGGER_ERROR(flushing, "not flushed by default");
+  REQUIRE(sink->flushes() == 0);
+
+  flushing.set_flush_level(lee::level_enum::warn);
+  LOGGER_INFO(flushing, "below flush level");
+  REQUIRE(sink->flushes() == 0);
+  LOGGER_WARN(flushing, "at flush level");
+  REQUIRE(sink->flushes() == 1);
+
+  lee::logger_registry::get_instance().flush_all();
+  REQUIRE(sink->flushes() == 2);
+  flushing.remove_sink(sink);
+}
+
+TEST_CASE("named loggers write independently from several threads",
+          "[my_log][registry]") {
+  constexpr int PER_THREAD = 20000;
+  auto market_count = std::make_shared<lee::counting_sink<std::mutex>>();
+  auto control_count = std::make_shared<lee::counting_sink<std::mutex>>();
+  LEE_LOGGER("registry.threads.market").add_sink(market_count);
+  LEE_LOGGER("registry.threads.control").add_sink(control_count);
+
+  std::vector<std::thread> workers;
+  for (int t = 0; t < 2; ++t) {
+    workers.emplace_back([] {
+      for (int i = 0; i < PER_THREAD; ++i) {
+        LOGGER_INFO(LEE_LOGGER("registry.threads.market"),
+                    lee::lazy_concat() + "tick " + i);
+      }
+    });
+  }
+  workers.emplace_back([] {
+    for (int i = 0; i < PER_THREAD; ++i) {
+      LOGGER_WARN_FMT(LEE_LOGGER("registry.threads.control"), "cmd {}", i);
+    }
+  });
+  for (auto& it : workers) {
+    it.join();
+  }
+  REQUIRE(market_count->count(lee::level_enum::info) == 2u * PER_THREAD);
+  REQUIRE(control_count->count(lee::level_enum::warn) == 1u * PER_THREAD);
+}
+
+TEST_CASE("filtered named logger call benchmark", "[my_log][registry]") {
+  constexpr int ITERATIONS = 10000000;
+  auto sink = std::make_shared<capture_sink>();
+  sink->set_level(lee::level_enum::error);
+  LEE_LOGGER("registry.bench").add_sink(sink);
+
+  int evaluated = 0;
+  const auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < ITERATIONS; ++i) {
+    LOGGER_DEBUG(LEE_LOGGER("registry.bench"), ++evaluated);
+  }
+  const auto end = std::chrono::steady_clock::now();
+  REQUIRE(evaluated == 0);
+  std::cout << "filtered LOGGER_DEBUG: "
+            << std::chrono::duration<double, std::nano>(end - begin).count() /
+                   ITERATIONS
+            << " ns/call" << std::endl;
+}
@@ -0,0 +1,104 @@
+/// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
+///
+/// Use of this source code is governed by a MIT license
+/// that can be found in the License file.
+
+#include <catch2/catch.hpp>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "my_log/log.hpp"
+#include "profiler.hpp"
+
+namespace {
+std::string read_file(const std::string& filename) {
+  std::ifstream ifs(filename, std::ifstream::binary);
+  std::ostringstream oss;
+  oss << ifs.rdbuf();
+  return oss.str();
+}
+}  // namespace
+
+TEST_CASE("rotating_file_sink double buffer", "[my_log][rotating_file_sink]") {
+  const std::string filename = "test_logs/double_buffer.log";
+  lee::remove_if_exists(filename);
+  {
+    lee::rotating_file_sink<std::mutex> sink(filename, 1024 * 1024, 2);
+    sink.enable_double_buffer(4096, std::chrono::milliseconds(1000));
+    PROFILER_F();
+    for (int i = 0; i < 10000; ++i) {
+      sink.log("line " + std::to_string(i) + "\n");
+    }
+    sink.disable_double_buffer();
+    auto content = read_file(filename);
+    REQUIRE(content.find("line 0\n") == 0);
+    REQUIRE(content.find("line 9999\n") != std::string::npos);
+  }
+}
+
+TEST_CASE("rotating_file_sink double buffer swap timeout",
+          "[my_log][rotating_file_sink]") {
+  const std::string filename = "test_logs/double_buffer_timeout.log";
+  lee::remove_if_exists(filename);
+  lee::rotating_file_sink<std::mutex> sink(filename);
+  sink.enable_double_buffer(1024 * 1024, std::chrono::milliseconds(10));
+  sink.log("before timeout\n");
+  for (int i = 0; i < 500 && read_file(filename).empty(); ++i) {
+    lee::sleep_for_millis(2);
+  }
+  REQUIRE(read_file(filename) == "before timeout\n");
+}
+
+TEST_CASE("rotating_file_sink double buffer rotation",
+          "[my_log][rotating_file_sink]") {
+  const std::string filename = "test_logs/double_buffer_rotate.log";
+  constexpr std::size_t max_size = 2000;
+  constexpr std::size_t max_files = 3;
+  for (std::size_t i = 0; i <= max_files; ++i) {
+    lee::remove_if_exists(
+        lee::rotating_file_sink<std::mutex>::calc_filename(filename, i));
+  }
+  lee::rotating_file_sink<std::mutex> sink(filename, max_size, max_files);
+  sink.enable_double_buffer(256, std::chrono::milliseconds(1));
+  const std::string line(99, 'x');
+  for (int i = 0; i < 200; ++i) {
+    sink.log(line + "\n");
+    if (i % 5 == 0) {
+      lee::sleep_for_millis(1);
+    }
+  }
+  sink.disable_double_buffer();
+  /// 每个缓冲区只含整行, 文件大小不超过上限且都是整行
+  for (std::size_t i = 0; i <= max_files; ++i) {
+    auto content = read_file(
+        lee::rotating_file_sink<std::mutex>::calc_filename(filename, i));
+    REQUIRE(content.size() <= max_size);
+    REQUIRE(content.size() % (line.size() + 1) == 0);
+  }
+}
+
+TEST_CASE("rotating_file_sink double buffer waits for the writer",
+          "[my_log][rotating_file_sink]") {
+  const std::string filename = "test_logs/double_buffer_backpressure.log";
+  lee::remove_if_exists(filename);
+  lee::rotating_file_sink<std::mutex> sink(filename, 1024 * 1024, 2);
+  /// 超时很长, 只有前台缓冲区写满时才交换, 生产者多数时候要等写线程
+  sink.enable_double_buffer(64, std::chrono::milliseconds(10000));
+  constexpr int LINES = 2000;
+  for (int i = 0; i < LINES; ++i) {
+    sink.log("line " + std::to_string(i) + "\n");
+  }
+  sink.log(std::string(200, 'y') + "\n");
+  sink.disable_double_buffer();
+
+  const auto content = read_file(filename);
+  std::size_t lines = 0;
+  for (auto c : content) {
+    lines += c == '\n' ? 1 : 0;
+  }
+  REQUIRE(lines == LINES + 1);
+  REQUIRE(content.find("line 0\n") == 0);
+  REQUIRE(content.find("line 1999\n" + std::string(200, 'y')) !=
+          std::string::npos);
+}
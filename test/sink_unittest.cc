@@ -0,0 +1,210 @@
+/// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
+///
+/// Use of this source code is governed by a MIT license
+/// that can be found in the License file.
+
+#include <catch2/catch.hpp>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "log_wrapper.hpp"
+#include "my_log/static_logger.hpp"
+#include "profiler.hpp"
+
+namespace {
+lee::log_record make_record(const lee::log_site& site,
+                            std::string_view payload) {
+  lee::log_record record;
+  record.site = &site;
+  record.time = lee::log_clock::now();
+  record.thread = &lee::current_thread_identity();
+  record.payload = payload;
+  return record;
+}
+}  // namespace
+
+TEST_CASE("formatter renders a record", "[my_log][sink]") {
+  LEE_LOG_SITE(site, lee::level_enum::info);
+  auto record = make_record(site, "[a] [b] payload");
+  std::string out = "prefix";
+  lee::formatter f;
+  auto range = f.format(record, out);
+  REQUIRE(out.substr(range.begin, range.end - range.begin) == "info");
+  REQUIRE(out.find("] [info]  [a] [b] payload <In Function: ") !=
+          std::string::npos);
+  REQUIRE(out.find(", File: sink_unittest.cc, Line: " +
+                   std::to_string(site.line) + ", " +
+                   lee::current_thread_identity().rendered + ">\n") !=
+          std::string::npos);
+}
+
+TEST_CASE("stdout_sink colors the level without parsing the message",
+          "[my_log][sink]") {
+  LEE_LOG_SITE(site, lee::level_enum::warn);
+  lee::stdout_sink<std::mutex> sink;
+  std::ostringstream captured;
+  auto* old = std::cout.rdbuf(captured.rdbuf());
+  sink.log(make_record(site, "x]] [[y"));
+  std::cout.rdbuf(old);
+  REQUIRE(captured.str().find("warn") != std::string::npos);
+  REQUIRE(captured.str().find("x]] [[y <In Function: ") != std::string::npos);
+}
+
+TEST_CASE("counting_sink does no formatting", "[my_log][sink]") {
+  LEE_LOG_SITE(info_site, lee::level_enum::info);
+  LEE_LOG_SITE(error_site, lee::level_enum::error);
+  lee::counting_sink<std::mutex> sink;
+  for (int i = 0; i < 3; ++i) {
+    sink.log(make_record(info_site, "info"));
+  }
+  sink.log(make_record(error_site, "error"));
+  REQUIRE(sink.count(lee::level_enum::info) == 3);
+  REQUIRE(sink.count(lee::level_enum::error) == 1);
+  REQUIRE(sink.total() == 4);
+}
+
+TEST_CASE("formatter pattern", "[my_log][sink]") {
+  LEE_LOG_SITE(site, lee::level_enum::error);
+  auto record = make_record(site, "payload");
+  const auto& thread = lee::current_thread_identity();
+
+  lee::formatter f("%l %v [%s:%#] %P/%t%N %% %q");
+  std::string out;
+  auto range = f.format(record, out);
+  REQUIRE(out == "error payload [sink_unittest.cc:" + std::to_string(site.line) +
+                     "] " + std::to_string(thread.process_id) + "/" +
+                     std::to_string(thread.tid) + " % %q\n");
+  REQUIRE(out.substr(range.begin, range.end - range.begin) == "error");
+
+  f.set_pattern("%T|%!%");
+  out.clear();
+  f.format(record, out);
+  REQUIRE(out.size() == std::string("2026-10-17 00:00:00.000|").size() +
+                            std::string(site.func).size() + 2);
+  REQUIRE(out.substr(out.size() - 2) == "%\n");
+}
+
+TEST_CASE("formatter benchmark", "[my_log][sink]") {
+  LEE_LOG_SITE(site, lee::level_enum::info);
+  auto record = make_record(site, "benchmark payload 12345");
+  constexpr int COUNT = 200000;
+  std::size_t total = 0;
+  {
+    /// 早期 get_format_log 的拼接方式
+    PROFILER_F();
+    for (int i = 0; i < COUNT; ++i) {
+      std::string line =
+          lee::get_time_string() + " " +
+          std::string(lee::get_level_string(site.level)) + " " +
+          std::string(record.payload) + " <In Function: " + site.func +
+          ", File: " + site.file + ", Line: " + std::to_string(site.line) +
+          ", " + record.thread->rendered + ">\n";
+      total += line.size();
+    }
+  }
+  std::string out;
+  lee::formatter full;
+  {
+    PROFILER_F();
+    for (int i = 0; i < COUNT; ++i) {
+      out.clear();
+      full.format(record, out);
+      total += out.size();
+    }
+  }
+  lee::formatter compact("%T %l %v [%s:%#]");
+  {
+    PROFILER_F();
+    for (int i = 0; i < COUNT; ++i) {
+      out.clear();
+      compact.format(record, out);
+      total += out.size();
+    }
+  }
+  REQUIRE(total > 0);
+}
+
+namespace {
+/// 不派生自 base_sink 的 sink, 只需要三个成员函数
+struct vector_sink {
+  std::vector<std::string> lines;
+  bool should_log(lee::level_enum level) const {
+    return level >= lee::level_enum::warn;
+  }
+  void log(const lee::log_record& record) {
+    lines.emplace_back(record.payload);
+  }
+  void flush() {}
+};
+}  // namespace
+
+TEST_CASE("static_logger dispatches to every sink", "[my_log][sink]") {
+  lee::static_logger<lee::counting_sink<std::mutex>,
+                     lee::counting_sink<std::mutex>, vector_sink>
+      logger;
+  logger.sink<1>().set_level(lee::level_enum::error);
+  REQUIRE(logger.should_log(lee::level_enum::trace));
+
+  LEE_LOG_SITE(info_site, lee::level_enum::info);
+  LEE_LOG_SITE(error_site, lee::level_enum::error);
+  logger.log(info_site, "info");
+  logger.log(make_record(error_site, "error"));
+  logger.flush();
+
+  REQUIRE(logger.sink<0>().total() == 2);
+  REQUIRE(logger.sink<1>().total() == 1);
+  REQUIRE(logger.sink<1>().count(lee::level_enum::error) == 1);
+  REQUIRE(logger.sink<vector_sink>().lines == std::vector<std::string>{"error"});
+}
+
+TEST_CASE("static_logger constructs sinks in place", "[my_log][sink]") {
+  const std::string path = "log/static_logger/static_logger.log";
+  lee::static_logger<lee::rotating_file_sink<std::mutex>,
+                     lee::counting_sink<std::mutex>>
+      logger(std::make_tuple(path), std::make_tuple());
+  REQUIRE(logger.sink<0>().filename() == path);
+  LEE_LOG_SITE(site, lee::level_enum::info);
+  logger.log(site, "static logger record");
+  logger.flush();
+  REQUIRE(logger.sink<1>().total() == 1);
+
+  logger.set_level(lee::level_enum::off);
+  REQUIRE_FALSE(logger.should_log(lee::level_enum::critical));
+}
+
+TEST_CASE("static_logger dispatch benchmark", "[my_log][sink]") {
+  constexpr int COUNT = 1000000;
+  LEE_LOG_SITE(site, lee::level_enum::info);
+  const auto record = make_record(site, "dispatch");
+
+  std::vector<std::unique_ptr<lee::sink>> runtime;
+  runtime.emplace_back(new lee::counting_sink<std::mutex>());
+  runtime.emplace_back(new lee::counting_sink<std::mutex>());
+  {
+    PROFILER_F();
+    for (int i = 0; i < COUNT; ++i) {
+      for (auto& it : runtime) {
+        if (it->should_log(record.level())) {
+          it->log(record);
+        }
+      }
+    }
+  }
+
+  lee::static_logger<lee::counting_sink<std::mutex>,
+                     lee::counting_sink<std::mutex>>
+      compiled;
+  {
+    PROFILER_F();
+    for (int i = 0; i < COUNT; ++i) {
+      compiled.log(record);
+    }
+  }
+  REQUIRE(compiled.sink<0>().total() == COUNT);
+  REQUIRE(compiled.sink<1>().total() == COUNT);
+}
@@ -0,0 +1,90 @@
+/// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
+///
+/// Use of this source code is governed by a MIT license
+/// that can be found in the License file.
+
+#include "my_log/timestamp.hpp"
+
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <string>
+
+#include "my_log/os.hpp"
+#include "profiler.hpp"
+
+namespace {
+/// 原来 get_time_string 的实现, 作为对照
+std::string reference_time_string(
+    const std::chrono::system_clock::time_point& time_point, bool utc) {
+  auto t = std::chrono::duration_cast<std::chrono::milliseconds>(
+               time_point.time_since_epoch())
+               .count();
+  tm buf;
+  time_t t1 = static_cast<time_t>(t / 1000);
+#ifdef _WIN32
+  utc ? gmtime_s(&buf, &t1) : localtime_s(&buf, &t1);
+#else
+  utc ? gmtime_r(&t1, &buf) : localtime_r(&t1, &buf);
+#endif
+  char p[32] = {0};
+  strftime(p, sizeof(p), "[%F %T", &buf);
+  auto time_str = std::to_string(t % 1000);
+  while (time_str.size() < 3) {
+    time_str = "0" + time_str;
+  }
+  return std::string(p) + "." + time_str + "]";
+}
+}  // namespace
+
+TEST_CASE("timestamp matches strftime", "[my_log][timestamp]") {
+  using std::chrono::system_clock;
+  const std::int64_t seconds[] = {0,          951782400,  1582934399,
+                                  1609459199, 1700000000, 4102444800};
+  for (auto sec : seconds) {
+    for (int ms : {0, 7, 99, 500, 999}) {
+      system_clock::time_point tp(std::chrono::duration_cast<
+                                  system_clock::duration>(
+          std::chrono::seconds(sec) + std::chrono::milliseconds(ms)));
+      REQUIRE(lee::timestamp_string(tp) == reference_time_string(tp, false));
+      REQUIRE(lee::timestamp_string(tp, lee::time_precision::milliseconds,
+                                    lee::time_zone::utc) ==
+              reference_time_string(tp, true));
+    }
+  }
+}
+
+TEST_CASE("timestamp precision", "[my_log][timestamp]") {
+  using std::chrono::system_clock;
+  system_clock::time_point tp(
+      std::chrono::duration_cast<system_clock::duration>(
+          std::chrono::seconds(1700000000) + std::chrono::nanoseconds(1234567)));
+  REQUIRE(lee::timestamp_string(tp, lee::time_precision::microseconds,
+                                lee::time_zone::utc) ==
+          "[2023-11-14 22:13:20.001234]");
+  /// system_clock 在 Windows 上只有100纳秒精度
+  REQUIRE(lee::timestamp_string(tp, lee::time_precision::nanoseconds,
+                                lee::time_zone::utc)
+              .substr(0, 27) == "[2023-11-14 22:13:20.001234");
+  REQUIRE(lee::timestamp_string(tp, lee::time_precision::nanoseconds,
+                                lee::time_zone::utc)
+              .size() == 31);
+}
+
+TEST_CASE("timestamp效能测试", "[my_log][timestamp]") {
+  std::size_t total = 0;
+  {
+    PROFILER_F();
+    for (int i = 0; i < 100000; ++i) {
+      total += reference_time_string(std::chrono::system_clock::now(), false)
+                   .size();
+    }
+  }
+  {
+    PROFILER_F();
+    char buf[lee::MAX_TIMESTAMP_SIZE];
+    for (int i = 0; i < 100000; ++i) {
+      total += lee::format_timestamp(buf, std::chrono::system_clock::now());
+    }
+  }
+  REQUIRE(total == 2 * 100000 * 25);
+}
@@ -0,0 +1,73 @@
+/// Copyright (c) 2019,2020 Lijiancong. All rights reserved.
+///
+/// Use of this source code is governed by a MIT license
+/// that can be found in the License file.
+
+#include "my_log/tsc_clock.hpp"
+
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "log_wrapper.hpp"
+#include "profiler.hpp"
+
+namespace {
+std::int64_t abs_diff_ms(std::chrono::system_clock::time_point a,
+                         std::chrono::system_clock::time_point b) {
+  auto diff = std::chrono::duration_cast<std::chrono::milliseconds>(a - b);
+  return diff.count() < 0 ? -diff.count() : diff.count();
+}
+}  // namespace
+
+TEST_CASE("tsc_clock tracks system_clock", "[my_log][tsc_clock]") {
+  auto& clock = lee::tsc_clock::get_instance();
+  INFO("using tsc: " << clock.using_tsc());
+  REQUIRE(abs_diff_ms(clock.to_time_point(clock.ticks()),
+                      std::chrono::system_clock::now()) < 5);
+
+  const auto start = clock.ticks();
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  const auto elapsed_ms = clock.ticks_to_ns(clock.ticks() - start) / 1e6;
+  REQUIRE(elapsed_ms >= 19);
+  REQUIRE(elapsed_ms < 200);
+
+  clock.calibrate();
+  REQUIRE(abs_diff_ms(clock.to_time_point(clock.ticks()),
+                      std::chrono::system_clock::now()) < 5);
+}
+
+TEST_CASE("log_clock switches source", "[my_log][tsc_clock]") {
+  auto stamp = lee::log_clock::now();
+  REQUIRE(stamp.source == lee::clock_source::system);
+
+  lee::log_wrapper::get_instance().set_clock_source(lee::clock_source::tsc);
+  auto tsc_stamp = lee::log_clock::now();
+  REQUIRE(tsc_stamp.source == lee::clock_source::tsc);
+  /// 切换后之前记录的时间戳仍按原来的来源换算
+  REQUIRE(abs_diff_ms(lee::log_clock::to_time_point(stamp),
+                      lee::log_clock::to_time_point(tsc_stamp)) < 5);
+  LOG_INFO("tsc clock record");
+  lee::log_wrapper::get_instance().set_clock_source(
+      lee::clock_source::system);
+}
+
+TEST_CASE("tsc_clock benchmark", "[my_log][tsc_clock]") {
+  std::uint64_t sink = 0;
+  {
+    PROFILER_F();
+    for (int i = 0; i < 1000000; ++i) {
+      sink += lee::tsc_clock::get_instance().ticks();
+    }
+  }
+  {
+    PROFILER_F();
+    for (int i = 0; i < 1000000; ++i) {
+      sink += static_cast<std::uint64_t>(
+          std::chrono::system_clock::now().time_since_epoch().count());
+    }
+  }
+  REQUIRE(sink != 0);
+}